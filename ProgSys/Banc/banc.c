@@ -0,0 +1,806 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <sched.h>      // sched_yield
+#include <getopt.h>
+#include <stdatomic.h>
+#include "../Outils/futex.h"
+#include "../Outils/histo.h"                // Horloge + histogramme de latence
+#include "../Outils/charge.h"               // Calendrier d'envoi en boucle ouverte
+#include "../Outils/evenement.h"            // eventfd + epoll
+#include "../FichierSepare/4-common.h"      // Anneau V4 (segment + API zéro copie)
+
+// =================================================================
+// BANC D'ESSAI : DÉBIT ET LATENCE DES DIFFÉRENTS TRANSPORTS
+// =================================================================
+// Chaque programme de démonstration est rythmé par sleep(1) et affiche chaque
+// message : impossible de les comparer. Ici, on rejoue le MÊME schéma de
+// synchronisation que chaque version, mais sans pause ni affichage :
+//   thread          : Thread/3-Thread          (mutex + 2 sémaphores, threads)
+//   thread-mpmc     : Thread/5-Thread          (file MPMC sans verrou + futex)
+//   fork            : Fork/3-Fork              (sémaphores anonymes dans un mmap partagé)
+//   forkcommunicant : ForkCommunicant/2-...    (sem_trywait + usleep + lecture du tube)
+//   forkcommunicant-ev : ForkCommunicant/3-... (eventfd + epoll sur compteur ET tube)
+//   shm-nomme       : FichierSepare/3-*        (shm_open + sem_open, lecture du tube)
+//   shm-anneau      : FichierSepare/4-*        (anneau SPSC + futex, boîte aux lettres)
+//
+// Chaque message commence par un en-tête : l'heure de son dépôt (8 octets) puis
+// sa longueur totale (4 octets). Le consommateur en déduit la latence de
+// transfert (dépôt -> retrait) et le nombre d'octets utiles.
+//
+// Par défaut les producteurs envoient aussi vite que possible (boucle fermée).
+// Avec -l, ils suivent un calendrier (boucle ouverte, voir Outils/charge.h) et
+// l'heure inscrite est l'heure PRÉVUE : un retard du producteur compte alors
+// dans la latence au lieu de disparaître. -z fait varier la taille des messages
+// et -w simule un temps de traitement par message côté consommateur.
+// Les résultats sortent en CSV (une ligne par combinaison du balayage).
+//
+// ATTENTION : shm-anneau utilise le segment /mon_shm_v4 ; ne pas lancer le banc
+// pendant une démonstration V4.
+
+#define TAILLE_MAX TAILLE_CASE_MAX  // Taille max d'un message (octets)
+#define ENTETE_MSG 16               // Horodatage (8) + longueur (4) + bourrage
+#define TAILLE_MIN ENTETE_MSG       // Il faut au moins la place de l'en-tête
+#define MAX_CONSO 64                // Nombre max de producteurs (et de consommateurs)
+#define MAX_VALEURS 16              // Nombre max de valeurs par liste de balayage
+#define ATTENTE_POLL_US 100000      // Pause de ForkCommunicant quand rien n'est prêt
+
+// Noms des ressources du transport shm-nomme (distincts de ceux de la V3).
+#define BANC_SHM "/banc_shm"
+#define BANC_SEM_PLACES "/banc_sem_places"
+#define BANC_SEM_ITEMS "/banc_sem_items"
+#define BANC_SEM_MUTEX "/banc_sem_mutex"
+
+enum { T_THREAD, T_MPMC, T_FORK, T_COMMUNICANT, T_EVENEMENT, T_NOMME, T_ANNEAU, NB_TRANSPORTS };
+
+typedef struct {
+    const char *nom;
+    int processus;   // 1 : producteurs et consommateurs sont des processus (fork)
+    int multi;       // 1 : accepte plusieurs producteurs / consommateurs
+} Transport;
+
+static const Transport transports[NB_TRANSPORTS] = {
+    { "thread",          0, 1 },
+    { "thread-mpmc",     0, 1 },
+    { "fork",            1, 1 },
+    { "forkcommunicant", 1, 1 },
+    { "forkcommunicant-ev", 1, 1 },
+    { "shm-nomme",       1, 1 },
+    { "shm-anneau",      1, 0 },  // Anneau SPSC : 1 producteur, 1 consommateur
+};
+
+// --- MESURES D'UN CONSOMMATEUR ---
+typedef struct {
+    _Alignas(TAILLE_LIGNE) Histogramme latence;
+    uint64_t octets;
+} Mesure;
+
+// --- ÉTAT D'UN ESSAI (en mémoire partagée : visible des threads ET des fils) ---
+typedef struct {
+    // Paramètres
+    int transport;
+    int nb_prod;
+    int nb_conso;
+    unsigned long capacite;
+    unsigned long taille;
+    long par_producteur;        // Nombre de messages par producteur (-1 : mode durée)
+    uint64_t duree_ns;
+    Charge charge;              // Profil d'envoi (débit PAR producteur) et loi de taille
+    uint64_t service_ns;        // Temps de traitement simulé par message
+
+    // Départ groupé : chacun se déclare prêt, puis attend le top départ.
+    _Atomic int prets;
+    _Atomic int depart;
+    uint64_t debut_ns;
+    uint64_t fin_ns;            // Heure d'arrêt des producteurs (mode durée)
+    _Atomic int prod_finis;
+    _Atomic int conso_finis;
+    uint64_t arrivee_ns;        // Heure où le dernier consommateur a fini
+
+    // Transports à sémaphores (thread, fork, forkcommunicant[-ev])
+    sem_t places_libres;
+    sem_t items_existants;
+    sem_t mutex;
+    unsigned long i;
+    unsigned long j;
+
+    // Transport thread-mpmc
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long pos_ecriture;
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long pos_lecture;
+    _Alignas(TAILLE_LIGNE) Parking parking_prod;
+    _Alignas(TAILLE_LIGNE) Parking parking_conso;
+
+    // Mesures propres à chaque consommateur (aucun partage pendant la mesure)
+    Mesure mesures[MAX_CONSO];
+
+    // Séquences MPMC (une par ligne de cache) puis cases
+    _Alignas(TAILLE_LIGNE) unsigned char zone[];
+} Banc;
+
+// --- ÉTAT LOCAL AU PROCESSUS (hérité par fork) ---
+Banc *banc = NULL;
+unsigned char *cases = NULL;                 // Cases du transport courant
+pthread_mutex_t verrou = PTHREAD_MUTEX_INITIALIZER; // Transport thread
+sem_t *n_places, *n_items, *n_mutex;         // Transport shm-nomme
+MemoirePartagee *anneau = NULL;              // Transport shm-anneau
+Projection proj_anneau;
+Cote cote;                                   // Côté de l'anneau tenu par ce processus
+int efd_places = -1, efd_items = -1;         // Transport forkcommunicant-ev
+int ep = -1;                                 // epoll propre à ce processus
+int fd_tube = -1;                            // Tube de contrôle (jamais alimenté)
+int fd_tube_ecriture = -1;                   // Gardé ouvert : sinon le tube serait "fermé" (EOF)
+int avec_tube = 1;
+volatile sig_atomic_t stop = 0;              // Jamais levé : exigé par l'API V4
+const char *texte_profil = "ferme";          // Options -l et -z telles que saisies (CSV)
+const char *texte_loi = "fixe";
+
+#define SEQUENCE(b, k) ((_Atomic unsigned long *) &(b)->zone[(k) * TAILLE_LIGNE])
+#define CASE(k) (&cases[(k) * banc->taille])
+
+// Longueur totale d'un message (en-tête compris), lue dans son en-tête.
+static inline uint32_t longueur_msg(const unsigned char *m) {
+    uint32_t n;
+    memcpy(&n, m + sizeof(uint64_t), sizeof(n));
+    return n;
+}
+
+// Copie d'un message : seuls ses 'longueur' premiers octets ont un sens.
+static inline void copier_msg(unsigned char *dst, const unsigned char *src) {
+    memcpy(dst, src, longueur_msg(src));
+}
+
+
+// =================================================================
+// LECTURE DU TUBE DE CONTRÔLE
+// =================================================================
+// Les versions pilotables font un read() non bloquant à CHAQUE tour de boucle :
+// c'est un appel système par message, il fait partie de leur coût réel.
+static void lire_tube(void) {
+    if (!avec_tube) return;
+    char buffer[128];
+    (void) read(fd_tube, buffer, sizeof(buffer) - 1);
+}
+
+
+// La V4 relève à la place la boîte aux lettres du segment : un chargement mémoire.
+// 'force' : relève même sans tube (une commande arrivée quand même a réveillé
+// reserver_case/lire_case, qui rendent NULL tant qu'elle n'est pas lue).
+static void relever_boite(int force) {
+    if (!avec_tube && !force) return;
+    char commande[TAILLE_BOITE];
+    (void) boite_lire(&cote, commande, sizeof(commande));
+}
+
+
+// =================================================================
+// DÉPÔT / RETRAIT POUR CHAQUE TRANSPORT
+// =================================================================
+
+// Attente bloquante qui ignore les interruptions (EINTR).
+static void attendre(sem_t *s) {
+    while (sem_wait(s) == -1 && errno == EINTR) {}
+}
+
+static void mpmc_deposer(Banc *b, const unsigned char *msg) {
+    for (;;) {
+        unsigned long pos = atomic_load_explicit(&b->pos_ecriture, memory_order_relaxed);
+        for (;;) {
+            _Atomic unsigned long *seq = SEQUENCE(b, pos % b->capacite);
+            long diff = (long) (atomic_load_explicit(seq, memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (atomic_compare_exchange_weak_explicit(&b->pos_ecriture, &pos, pos + 1,
+                                                          memory_order_relaxed, memory_order_relaxed)) {
+                    copier_msg(CASE(pos % b->capacite), msg);
+                    atomic_store_explicit(seq, pos + 1, memory_order_release);
+                    parking_reveiller(&b->parking_conso, 1);
+                    return;
+                }
+            } else if (diff < 0) {
+                break; // PLEINE
+            } else {
+                pos = atomic_load_explicit(&b->pos_ecriture, memory_order_relaxed);
+            }
+        }
+        // Même protocole que 5-Thread : on re-vérifie avant de dormir.
+        unsigned int v = parking_preparer(&b->parking_prod);
+        unsigned long pos2 = atomic_load_explicit(&b->pos_ecriture, memory_order_seq_cst);
+        unsigned long seq = atomic_load_explicit(SEQUENCE(b, pos2 % b->capacite), memory_order_seq_cst);
+        if ((long) (seq - pos2) < 0) parking_dormir(&b->parking_prod, v, 1);
+        else parking_annuler(&b->parking_prod);
+    }
+}
+
+static void mpmc_retirer(Banc *b, unsigned char *msg) {
+    for (;;) {
+        unsigned long pos = atomic_load_explicit(&b->pos_lecture, memory_order_relaxed);
+        for (;;) {
+            _Atomic unsigned long *seq = SEQUENCE(b, pos % b->capacite);
+            long diff = (long) (atomic_load_explicit(seq, memory_order_acquire) - (pos + 1));
+            if (diff == 0) {
+                if (atomic_compare_exchange_weak_explicit(&b->pos_lecture, &pos, pos + 1,
+                                                          memory_order_relaxed, memory_order_relaxed)) {
+                    copier_msg(msg, CASE(pos % b->capacite));
+                    atomic_store_explicit(seq, pos + b->capacite, memory_order_release);
+                    parking_reveiller(&b->parking_prod, 1);
+                    return;
+                }
+            } else if (diff < 0) {
+                break; // VIDE
+            } else {
+                pos = atomic_load_explicit(&b->pos_lecture, memory_order_relaxed);
+            }
+        }
+        unsigned int v = parking_preparer(&b->parking_conso);
+        unsigned long pos2 = atomic_load_explicit(&b->pos_lecture, memory_order_seq_cst);
+        unsigned long seq = atomic_load_explicit(SEQUENCE(b, pos2 % b->capacite), memory_order_seq_cst);
+        if ((long) (seq - (pos2 + 1)) < 0) parking_dormir(&b->parking_conso, v, 1);
+        else parking_annuler(&b->parking_conso);
+    }
+}
+
+// Renvoie 0, ou -1 si l'essai est interrompu ('stop').
+static int deposer(Banc *b, const unsigned char *msg) {
+    switch (b->transport) {
+    case T_THREAD:
+        attendre(&b->places_libres);
+        pthread_mutex_lock(&verrou);
+        copier_msg(CASE(b->i), msg);
+        b->i = (b->i + 1) % b->capacite;
+        pthread_mutex_unlock(&verrou);
+        sem_post(&b->items_existants);
+        break;
+    case T_MPMC:
+        mpmc_deposer(b, msg);
+        break;
+    case T_FORK:
+        attendre(&b->places_libres);
+        attendre(&b->mutex);
+        copier_msg(CASE(b->i), msg);
+        b->i = (b->i + 1) % b->capacite;
+        sem_post(&b->mutex);
+        sem_post(&b->items_existants);
+        break;
+    case T_COMMUNICANT:
+        // Jamais de sem_wait : on scrute le tube, on tente, sinon on dort 100 ms.
+        for (;;) {
+            lire_tube();
+            if (sem_trywait(&b->places_libres) == 0) break;
+            usleep(ATTENTE_POLL_US);
+        }
+        attendre(&b->mutex);
+        copier_msg(CASE(b->i), msg);
+        b->i = (b->i + 1) % b->capacite;
+        sem_post(&b->mutex);
+        sem_post(&b->items_existants);
+        break;
+    case T_EVENEMENT:
+        // Pas de sommeil à durée fixe : on dort dans epoll sur le compteur ET le tube.
+        for (;;) {
+            lire_tube();
+            if (evenement_prendre(efd_places)) break;
+            attente_bloquer(ep);
+        }
+        attendre(&b->mutex);
+        copier_msg(CASE(b->i), msg);
+        b->i = (b->i + 1) % b->capacite;
+        sem_post(&b->mutex);
+        evenement_signaler(efd_items);
+        break;
+    case T_NOMME:
+        lire_tube();
+        attendre(n_places);
+        attendre(n_mutex);
+        copier_msg(CASE(b->i), msg);
+        b->i = (b->i + 1) % b->capacite;
+        sem_post(n_mutex);
+        sem_post(n_items);
+        break;
+    case T_ANNEAU: {
+        relever_boite(0);
+        // NULL : arrêt, ou commande postée pendant l'attente -> on la relève
+        // et on réessaie (comme la boucle de 4-producteur).
+        char *d;
+        while ((d = reserver_case(&cote, &stop)) == NULL) {
+            if (stop) return -1;
+            relever_boite(1);
+        }
+        copier_msg((unsigned char *) d, msg);
+        valider_case(&cote, longueur_msg(msg));
+        break;
+    }
+    }
+    return 0;
+}
+
+// Renvoie 0, ou -1 si l'essai est interrompu ('stop').
+static int retirer(Banc *b, unsigned char *msg) {
+    switch (b->transport) {
+    case T_THREAD:
+        attendre(&b->items_existants);
+        pthread_mutex_lock(&verrou);
+        copier_msg(msg, CASE(b->j));
+        b->j = (b->j + 1) % b->capacite;
+        pthread_mutex_unlock(&verrou);
+        sem_post(&b->places_libres);
+        break;
+    case T_MPMC:
+        mpmc_retirer(b, msg);
+        break;
+    case T_FORK:
+        attendre(&b->items_existants);
+        attendre(&b->mutex);
+        copier_msg(msg, CASE(b->j));
+        b->j = (b->j + 1) % b->capacite;
+        sem_post(&b->mutex);
+        sem_post(&b->places_libres);
+        break;
+    case T_COMMUNICANT:
+        for (;;) {
+            lire_tube();
+            if (sem_trywait(&b->items_existants) == 0) break;
+            usleep(ATTENTE_POLL_US);
+        }
+        attendre(&b->mutex);
+        copier_msg(msg, CASE(b->j));
+        b->j = (b->j + 1) % b->capacite;
+        sem_post(&b->mutex);
+        sem_post(&b->places_libres);
+        break;
+    case T_EVENEMENT:
+        for (;;) {
+            lire_tube();
+            if (evenement_prendre(efd_items)) break;
+            attente_bloquer(ep);
+        }
+        attendre(&b->mutex);
+        copier_msg(msg, CASE(b->j));
+        b->j = (b->j + 1) % b->capacite;
+        sem_post(&b->mutex);
+        evenement_signaler(efd_places);
+        break;
+    case T_NOMME:
+        lire_tube();
+        attendre(n_items);
+        attendre(n_mutex);
+        copier_msg(msg, CASE(b->j));
+        b->j = (b->j + 1) % b->capacite;
+        sem_post(n_mutex);
+        sem_post(n_places);
+        break;
+    case T_ANNEAU: {
+        relever_boite(0);
+        const char *d;
+        while ((d = lire_case(&cote, &stop)) == NULL) {
+            if (stop) return -1;
+            relever_boite(1);
+        }
+        copier_msg(msg, (const unsigned char *) d);
+        liberer_case(&cote, longueur_msg(msg));
+        break;
+    }
+    }
+    return 0;
+}
+
+
+// =================================================================
+// ROUTINES DES PRODUCTEURS ET CONSOMMATEURS
+// =================================================================
+
+// Départ groupé : la création des threads/processus n'est pas chronométrée.
+static void attendre_depart(Banc *b) {
+    atomic_fetch_add(&b->prets, 1);
+    while (!atomic_load_explicit(&b->depart, memory_order_acquire)) sched_yield();
+}
+
+static void producteur(int id) {
+    Banc *b = banc;
+    unsigned char msg[TAILLE_MAX];
+    memset(msg, 'a' + id % 26, b->taille);
+    if (b->transport == T_ANNEAU) cote_attacher(&cote, anneau, 1);
+    if (b->transport == T_EVENEMENT) ep = attente_creer(efd_places, fd_tube);
+
+    Alea alea;
+    alea_init(&alea, id + 1);
+    int ouvert = b->charge.profil != PROFIL_FERME;
+
+    attendre_depart(b);
+    uint64_t prevu = b->debut_ns;
+    for (long k = 0; ; k++) {
+        uint64_t t;
+        if (ouvert) {
+            // Boucle ouverte : l'heure d'envoi est fixée par le calendrier,
+            // même si le message précédent est parti en retard.
+            prevu = charge_prochain(&b->charge, &alea, prevu, b->debut_ns);
+            t = prevu;
+        } else {
+            t = horloge_ns();
+        }
+        if (b->par_producteur >= 0 ? k >= b->par_producteur : t >= b->fin_ns) break;
+        if (ouvert) attendre_heure(prevu);
+
+        uint32_t n = charge_taille(&b->charge, &alea, b->taille);
+        if (n < ENTETE_MSG) n = ENTETE_MSG;
+        memcpy(msg, &t, sizeof(t));                     // Horodatage (prévu ou réel)
+        memcpy(msg + sizeof(uint64_t), &n, sizeof(n));  // Longueur
+        if (deposer(b, msg) == -1) break;
+    }
+
+    // Le DERNIER producteur à finir envoie une "pilule" (horodatage 0) par
+    // consommateur : elles passent forcément après tous les vrais messages.
+    if (atomic_fetch_add(&b->prod_finis, 1) + 1 == b->nb_prod) {
+        uint32_t n = ENTETE_MSG;
+        memset(msg, 0, sizeof(uint64_t));
+        memcpy(msg + sizeof(uint64_t), &n, sizeof(n));
+        for (int c = 0; c < b->nb_conso; c++) deposer(b, msg);
+    }
+}
+
+static void consommateur(int id) {
+    Banc *b = banc;
+    Mesure *m = &b->mesures[id];
+    unsigned char msg[TAILLE_MAX];
+    if (b->transport == T_ANNEAU) cote_attacher(&cote, anneau, 0);
+    if (b->transport == T_EVENEMENT) ep = attente_creer(efd_items, fd_tube);
+
+    attendre_depart(b);
+    for (;;) {
+        if (retirer(b, msg) == -1) break;
+        uint64_t t;
+        memcpy(&t, msg, sizeof(t));
+        if (t == 0) break;              // Pilule : fin de l'essai
+        histo_ajouter(&m->latence, horloge_ns() - t);
+        m->octets += longueur_msg(msg);
+        travail_simule(b->service_ns);
+    }
+    if (atomic_fetch_add(&b->conso_finis, 1) + 1 == b->nb_conso) b->arrivee_ns = horloge_ns();
+}
+
+static void *thread_producteur(void *arg) {
+    producteur((int) (long) arg);
+    return NULL;
+}
+
+static void *thread_consommateur(void *arg) {
+    consommateur((int) (long) arg);
+    return NULL;
+}
+
+
+// =================================================================
+// PRÉPARATION / NETTOYAGE D'UN ESSAI
+// =================================================================
+
+// Renvoie 0, ou -1 si le transport n'a pas pu être mis en place.
+static int preparer(Banc *b) {
+    unsigned long octets = b->capacite * b->taille;
+    cases = &b->zone[b->capacite * TAILLE_LIGNE];
+
+    switch (b->transport) {
+    case T_THREAD:
+        sem_init(&b->places_libres, 0, b->capacite);
+        sem_init(&b->items_existants, 0, 0);
+        break;
+    case T_MPMC:
+        for (unsigned long k = 0; k < b->capacite; k++) atomic_init(SEQUENCE(b, k), k);
+        break;
+    case T_FORK:
+    case T_COMMUNICANT:
+        sem_init(&b->places_libres, 1, b->capacite);
+        sem_init(&b->items_existants, 1, 0);
+        sem_init(&b->mutex, 1, 1);
+        break;
+    case T_EVENEMENT:
+        sem_init(&b->mutex, 1, 1);
+        efd_places = evenement_creer(b->capacite);
+        efd_items = evenement_creer(0);
+        if (efd_places == -1 || efd_items == -1) {
+            perror("Erreur eventfd");
+            return -1;
+        }
+        break;
+    case T_NOMME: {
+        int fd = shm_open(BANC_SHM, O_CREAT | O_RDWR, 0666);
+        if (fd == -1 || ftruncate(fd, octets) == -1) {
+            perror("Erreur shm_open");
+            if (fd != -1) close(fd);
+            return -1;
+        }
+        cases = mmap(NULL, octets, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (cases == MAP_FAILED) {
+            perror("Erreur mmap");
+            shm_unlink(BANC_SHM);
+            return -1;
+        }
+        // Un ancien sémaphore aurait une valeur fausse : on repart de zéro.
+        sem_unlink(BANC_SEM_PLACES);
+        sem_unlink(BANC_SEM_ITEMS);
+        sem_unlink(BANC_SEM_MUTEX);
+        n_places = sem_open(BANC_SEM_PLACES, O_CREAT, 0666, b->capacite);
+        n_items = sem_open(BANC_SEM_ITEMS, O_CREAT, 0666, 0);
+        n_mutex = sem_open(BANC_SEM_MUTEX, O_CREAT, 0666, 1);
+        if (n_places == SEM_FAILED || n_items == SEM_FAILED || n_mutex == SEM_FAILED) {
+            perror("Erreur sem_open");
+            return -1;
+        }
+        break;
+    }
+    case T_ANNEAU: {
+        anneau = segment_creer(b->capacite, b->taille, 0, &proj_anneau);
+        if (anneau == NULL) return -1;
+        b->capacite = anneau->capacite; // Arrondie à une puissance de 2
+        break;
+    }
+    }
+
+    if (avec_tube) {
+        int tube[2];
+        if (pipe(tube) == -1) {
+            perror("Erreur pipe");
+            return -1;
+        }
+        fd_tube = tube[0];
+        fd_tube_ecriture = tube[1];
+        fcntl(fd_tube, F_SETFL, O_NONBLOCK);
+    }
+    return 0;
+}
+
+static void nettoyer(Banc *b, unsigned long octets) {
+    if (fd_tube != -1) {
+        close(fd_tube);
+        close(fd_tube_ecriture);
+    }
+    fd_tube = fd_tube_ecriture = -1;
+
+    switch (b->transport) {
+    case T_THREAD:
+        sem_destroy(&b->places_libres);
+        sem_destroy(&b->items_existants);
+        break;
+    case T_FORK:
+    case T_COMMUNICANT:
+        sem_destroy(&b->places_libres);
+        sem_destroy(&b->items_existants);
+        sem_destroy(&b->mutex);
+        break;
+    case T_EVENEMENT:
+        sem_destroy(&b->mutex);
+        close(efd_places);
+        close(efd_items);
+        efd_places = efd_items = -1;
+        break;
+    case T_NOMME:
+        munmap(cases, octets);
+        sem_close(n_places);
+        sem_close(n_items);
+        sem_close(n_mutex);
+        shm_unlink(BANC_SHM);
+        sem_unlink(BANC_SEM_PLACES);
+        sem_unlink(BANC_SEM_ITEMS);
+        sem_unlink(BANC_SEM_MUTEX);
+        break;
+    case T_ANNEAU:
+        segment_detacher(&proj_anneau);
+        segment_supprimer();
+        anneau = NULL;
+        break;
+    }
+}
+
+
+// =================================================================
+// UN ESSAI COMPLET
+// =================================================================
+static void lancer(int transport, unsigned long capacite, unsigned long taille,
+                   int nb_prod, int nb_conso, long messages, double duree,
+                   const Charge *charge, uint64_t service_ns, FILE *csv) {
+    const Transport *tr = &transports[transport];
+    size_t octets = sizeof(Banc) + capacite * TAILLE_LIGNE + capacite * taille;
+    Projection proj;
+    if (projeter_anonyme(&proj, octets, 0) == -1) return;
+    Banc *b = proj.adresse;          // mmap anonyme : tout est déjà à zéro
+    banc = b;
+
+    b->transport = transport;
+    b->nb_prod = nb_prod;
+    b->nb_conso = nb_conso;
+    b->capacite = capacite;
+    b->taille = taille;
+    b->par_producteur = (duree > 0) ? -1 : messages / nb_prod;
+    b->duree_ns = (uint64_t) (duree * 1e9);
+    b->charge = *charge;
+    b->charge.debit /= nb_prod;      // Le débit demandé est partagé entre les producteurs
+    b->service_ns = service_ns;
+
+    if (preparer(b) == -1) {
+        projection_liberer(&proj);
+        return;
+    }
+
+    // --- Lancement ---
+    int total = nb_prod + nb_conso;
+    pthread_t th[2 * MAX_CONSO];
+    pid_t pid[2 * MAX_CONSO];
+    for (int w = 0; w < total; w++) {
+        int prod = w < nb_prod;
+        int id = prod ? w : w - nb_prod;
+        if (tr->processus) {
+            pid[w] = fork();
+            if (pid[w] == 0) {
+                if (prod) producteur(id);
+                else consommateur(id);
+                _exit(0);
+            }
+        } else {
+            pthread_create(&th[w], NULL, prod ? thread_producteur : thread_consommateur,
+                           (void *) (long) id);
+        }
+    }
+
+    // --- Top départ ---
+    while (atomic_load(&b->prets) < total) sched_yield();
+    b->debut_ns = horloge_ns();
+    b->fin_ns = b->debut_ns + b->duree_ns;
+    atomic_store_explicit(&b->depart, 1, memory_order_release);
+
+    for (int w = 0; w < total; w++) {
+        if (tr->processus) waitpid(pid[w], NULL, 0);
+        else pthread_join(th[w], NULL);
+    }
+
+    // --- Résultats ---
+    Histogramme h;
+    uint64_t total_octets = 0;
+    histo_raz(&h);
+    for (int c = 0; c < nb_conso; c++) {
+        histo_fusionner(&h, &b->mesures[c].latence);
+        total_octets += b->mesures[c].octets;
+    }
+    double secondes = (double) (b->arrivee_ns - b->debut_ns) / 1e9;
+    double msgs_s = secondes > 0 ? (double) h.total / secondes : 0;
+    double octets_s = secondes > 0 ? (double) total_octets / secondes : 0;
+
+    fprintf(csv, "%s,%d,%d,%lu,%lu,%llu,%.6f,%.0f,%.0f,%llu,%llu,%llu,%llu,%llu,%s,%s,%llu\n",
+            tr->nom, nb_prod, nb_conso, b->capacite, taille,
+            (unsigned long long) h.total, secondes, msgs_s, octets_s,
+            (unsigned long long) histo_percentile(&h, 50.0),
+            (unsigned long long) histo_percentile(&h, 99.0),
+            (unsigned long long) histo_percentile(&h, 99.9),
+            (unsigned long long) h.max,
+            (unsigned long long) (h.total ? h.somme / h.total : 0),
+            texte_profil, texte_loi, (unsigned long long) service_ns);
+    fflush(csv);
+    fprintf(stderr, "%-18s P=%-2d C=%-2d cap=%-6lu taille=%-6lu : %12.0f msg/s  p50 %8llu ns  p99 %8llu ns  p99.9 %8llu ns\n",
+            tr->nom, nb_prod, nb_conso, b->capacite, taille, msgs_s,
+            (unsigned long long) histo_percentile(&h, 50.0),
+            (unsigned long long) histo_percentile(&h, 99.0),
+            (unsigned long long) histo_percentile(&h, 99.9));
+
+    nettoyer(b, capacite * taille);
+    projection_liberer(&proj);
+    banc = NULL;
+}
+
+
+// Lit une liste "16,256,4096" dans 'valeurs'. Renvoie le nombre de valeurs.
+static int lire_liste(const char *texte, long *valeurs) {
+    char copie[256];
+    snprintf(copie, sizeof(copie), "%s", texte);
+    int n = 0;
+    for (char *mot = strtok(copie, ","); mot != NULL && n < MAX_VALEURS; mot = strtok(NULL, ",")) {
+        valeurs[n++] = atol(mot);
+    }
+    return n;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage : %s [-t transport[,...]] [-n messages | -d secondes] [-c capacites]\n"
+            "          [-s tailles] [-p producteurs] [-q consommateurs] [-o fichier.csv] [-x]\n"
+            "          [-l profil] [-z loi_taille] [-w service_ns]\n"
+            "  -t : thread, thread-mpmc, fork, forkcommunicant,\n"
+            "       forkcommunicant-ev, shm-nomme, shm-anneau (tous par défaut)\n"
+            "  -n : nombre total de messages par essai (200000 par défaut)\n"
+            "  -d : durée de chaque essai, à la place de -n\n"
+            "  -c, -s, -p, -q : listes à balayer, ex. -c 16,256,4096 (1 valeur par défaut : 16, 64, 1, 1)\n"
+            "  -o : fichier CSV (sortie standard par défaut), résumé lisible sur stderr\n"
+            "  -x : ne pas relever les commandes (tube ou boîte aux lettres) à chaque message\n"
+            "  -l : ferme (défaut, aussi vite que possible), constant:DEBIT, poisson:DEBIT,\n"
+            "       rafales:DEBIT:ACTIF_MS:REPOS_MS  (DEBIT = messages/s, tous producteurs confondus)\n"
+            "  -z : fixe (défaut, taille de case), uniforme:MIN, expo:MOYENNE[:MIN]\n"
+            "  -w : temps de traitement simulé par message côté consommateur (ns)\n", prog);
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    int choisis[NB_TRANSPORTS] = { 0 };
+    int aucun = 1;
+    long messages = 200000;
+    double duree = 0;
+    long capacites[MAX_VALEURS] = { 16 }, tailles[MAX_VALEURS] = { 64 };
+    long prods[MAX_VALEURS] = { 1 }, consos[MAX_VALEURS] = { 1 };
+    int nb_c = 1, nb_s = 1, nb_p = 1, nb_q = 1;
+    FILE *csv = stdout;
+    Charge charge;
+    memset(&charge, 0, sizeof(charge));  // Boucle fermée, taille fixe
+    uint64_t service_ns = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:n:d:c:s:p:q:o:xl:z:w:")) != -1) {
+        switch (opt) {
+        case 't': {
+            char copie[256];
+            snprintf(copie, sizeof(copie), "%s", optarg);
+            for (char *mot = strtok(copie, ","); mot != NULL; mot = strtok(NULL, ",")) {
+                int t;
+                for (t = 0; t < NB_TRANSPORTS && strcmp(mot, transports[t].nom) != 0; t++) {}
+                if (t == NB_TRANSPORTS) usage(argv[0]);
+                choisis[t] = 1;
+                aucun = 0;
+            }
+            break;
+        }
+        case 'n': messages = atol(optarg); break;
+        case 'd': duree = atof(optarg); break;
+        case 'c': nb_c = lire_liste(optarg, capacites); break;
+        case 's': nb_s = lire_liste(optarg, tailles); break;
+        case 'p': nb_p = lire_liste(optarg, prods); break;
+        case 'q': nb_q = lire_liste(optarg, consos); break;
+        case 'o':
+            csv = fopen(optarg, "w");
+            if (csv == NULL) {
+                perror("Erreur fopen");
+                exit(1);
+            }
+            break;
+        case 'x': avec_tube = 0; break;
+        case 'l':
+            if (charge_lire_profil(&charge, optarg) == -1) usage(argv[0]);
+            texte_profil = optarg;
+            break;
+        case 'z':
+            if (charge_lire_loi(&charge, optarg) == -1) usage(argv[0]);
+            texte_loi = optarg;
+            break;
+        case 'w': service_ns = strtoull(optarg, NULL, 10); break;
+        default: usage(argv[0]);
+        }
+    }
+    if (messages < 1 || nb_c < 1 || nb_s < 1 || nb_p < 1 || nb_q < 1) usage(argv[0]);
+
+    fprintf(csv, "transport,producteurs,consommateurs,capacite,taille,messages,secondes,"
+                 "msgs_par_s,octets_par_s,p50_ns,p99_ns,p999_ns,max_ns,moyenne_ns,charge,loi_taille,service_ns\n");
+
+    for (int t = 0; t < NB_TRANSPORTS; t++) {
+        if (!aucun && !choisis[t]) continue;
+        for (int c = 0; c < nb_c; c++)
+        for (int s = 0; s < nb_s; s++)
+        for (int p = 0; p < nb_p; p++)
+        for (int q = 0; q < nb_q; q++) {
+            if (capacites[c] < 1 || (unsigned long) capacites[c] > CAPACITE_MAX
+                || tailles[s] < TAILLE_MIN || tailles[s] > TAILLE_MAX
+                || prods[p] < 1 || prods[p] > MAX_CONSO || consos[q] < 1 || consos[q] > MAX_CONSO) {
+                fprintf(stderr, "Combinaison ignorée (hors limites) : cap=%ld taille=%ld P=%ld C=%ld\n",
+                        capacites[c], tailles[s], prods[p], consos[q]);
+                continue;
+            }
+            if (!transports[t].multi && (prods[p] > 1 || consos[q] > 1)) continue;
+            lancer(t, capacites[c], tailles[s], (int) prods[p], (int) consos[q], messages, duree,
+                   &charge, service_ns, csv);
+        }
+    }
+
+    if (csv != stdout) fclose(csv);
+    return 0;
+}
@@ -2,6 +2,8 @@
 #define COMMON_H
 // ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
 
+#include <stdint.h>
+
 // --- PARAMÈTRES DU TAMPON ---
 #define N 10            // Nombre de places dans le tampon circulaire
 #define TAILLE_MSG 64   // Taille fixe en octets d'un message
@@ -27,6 +29,7 @@
 // Permet la copie par affectation (=) au lieu de strcpy().
 typedef struct {
     char texte[TAILLE_MSG];
+    uint64_t depose_ns; // Heure de la demande de dépôt (option -m : mesure du transfert), 0 sinon
 } Donnee;
 
 // --- STRUCTURE DE LA MÉMOIRE PARTAGÉE (Layout) ---
@@ -8,7 +8,12 @@
 #include <signal.h>
 #include <string.h>
 #include <errno.h>
+#include <getopt.h>     // Lecture des options -m -j -W
 #include "3-common.h"
+#include "../Outils/sonde.h" // Histogrammes de latence (option -m, affichés sur SIGUSR1)
+#include "../Outils/journal.h" // Traces hors section critique (option -j)
+#include "../Outils/attente.h" // Stratégie d'attente (option -W)
+#include "../Outils/controle.h" // Commandes du communicant en trames
 
 int stop = 0;
 
@@ -16,11 +21,40 @@ void handler(int sig) {
     stop = 1;
 }
 
-int main() {
+// Usage : ./3-consommateur [-m] [-j niveau] [-W strategie]
+//   -m : mesure chaque attente, chaque détention du verrou et, si le producteur
+//        horodate ses messages (-m aussi), chaque transfert complet.
+//        "kill -USR1 <pid>" affiche les histogrammes.
+//   -j : traces (0 = aucune, 1 = messages externes, 2 = chaque message, par défaut),
+//        écrites par un thread de journal : plus aucun printf sous le verrou.
+//   -W : attente d'un message (bloque, spin, cede, adapte ; "bloque" par défaut).
+//        Le bilan (attentes résolues en boucle, endormissements) est affiché à l'arrêt.
+int main(int argc, char *argv[]) {
+    int mesurer = 0;
+    int niveau = JOURNAL_TRACE;
+    int strategie = ATTENTE_BLOQUE;
+    int opt;
+    while ((opt = getopt(argc, argv, "mj:W:")) != -1) {
+        if (opt == 'm') mesurer = 1;
+        else if (opt == 'j') niveau = atoi(optarg);
+        else if (opt == 'W') {
+            if ((strategie = attente_lire(optarg)) == -1) {
+                fprintf(stderr, "Option -W : bloque, spin, cede ou adapte\n");
+                exit(1);
+            }
+        }
+        else exit(1);
+    }
+    Attente attente;
+    attente_init(&attente, strategie);
+    Sondes sondes;
+    sondes_init(&sondes, "Consommateur", mesurer);
+
     // 1. CONFIGURATION DU SIGNAL
     struct sigaction psa;
     psa.sa_handler = handler;
     sigaction(SIGINT, &psa, NULL);
+    sonde_installer();
 
     // 2. CONNEXION MÉMOIRE PARTAGÉE
     int fd_shm = shm_open(SHM_NAME, O_RDWR, 0666);
@@ -36,66 +70,76 @@ int main() {
     sem_t *mutex = sem_open(SEM_MUTEX, 0);
 
     // 3. MISE EN PLACE DU TUBE (FIFO)
-    mkfifo(FIFO_CONSO, 0666);
-    // Ouverture non-bloquante pour ne pas figer le programme
-    int fd_fifo = open(FIFO_CONSO, O_RDONLY | O_NONBLOCK);
+    // Ouverture non-bloquante pour ne pas figer le programme (commandes en trames)
+    Recepteur tube;
+    recepteur_ouvrir(&tube, FIFO_CONSO);
     
     printf("--- Consommateur V3 (Pilotable) Démarré ---\n");
+    fflush(stdout);     // Avant que le thread de journal n'écrive à son tour
+    if (journal_demarrer(niveau) == -1) perror("Avertissement : thread de journal");
+    journal_rejoindre();    // Canal pris ici, pas sous le verrou de la zone
 
     while (!stop) {
+        sonde_verifier(&sondes);
+
         // A. LECTURE DU TUBE (Prioritaire)
-        char buffer_cmd[128];
-        // On nettoie le buffer avant de lire pour éviter les résidus "bonjour"
-        memset(buffer_cmd, 0, sizeof(buffer_cmd));
-        
-        ssize_t octets_lus = read(fd_fifo, buffer_cmd, sizeof(buffer_cmd) - 1);
-        
-        if (octets_lus > 0) {
-            // Sécurité : On force la fin de chaîne
-            buffer_cmd[octets_lus] = '\0';
-            
+        // Chaque trame est une commande complète, terminée par '\0' : plus de
+        // résidus d'une commande précédente, ni de commandes collées.
+        char buffer_cmd[CONTROLE_MAX];
+        while (recepteur_lire(&tube, buffer_cmd, sizeof(buffer_cmd))) {
             if (strcmp(buffer_cmd, "stop") == 0) {
-                printf("\n[SYSTEM] Ordre d'arrêt reçu via le tube.\n");
+                journal_ecrire(JOURNAL_INFO, "\n[SYSTEM] Ordre d'arrêt reçu via le tube.\n", NULL, 0);
                 stop = 1;
                 break;
             } else {
                 // AFFICHAGE TRES VISIBLE POUR DISTINGUER
-                printf("\n**************************************************\n");
-                printf("   MESSAGE EXTERNE REÇU : %s\n", buffer_cmd);
-                printf("**************************************************\n\n");
+                journal_ecrire(JOURNAL_INFO,
+                               "\n**************************************************\n"
+                               "   MESSAGE EXTERNE REÇU : %s\n"
+                               "**************************************************\n\n",
+                               buffer_cmd, 0);
             }
         }
+        if (stop) break;
 
         // B. CONSOMMATION NORMALE (Flux du producteur)
         Donnee item;
         
-        if (sem_wait(items_existants) == -1) {
+        uint64_t t0 = sonde_debut(&sondes);
+        if (attente_sem(&attente, items_existants, &stop) == -1) {
             if (stop) break;
             if (errno == EINTR) continue;
         }
+        sonde_fin(&sondes, SONDE_ATTENTE, t0);
 
         sem_wait(mutex);
+        uint64_t t1 = sonde_debut(&sondes);
         item = partagee->tab[partagee->j];
         
-        // Affichage standard du flux
-        printf("<- Conso : Lu '%s' (idx %d)\n", item.texte, partagee->j);
+        // Affichage standard du flux (recopié, formaté plus tard hors du verrou)
+        journal_ecrire(JOURNAL_TRACE, "<- Conso : Lu '%s' (idx %d)\n", item.texte, partagee->j);
         
         partagee->j = (partagee->j + 1) % N;
+        sonde_fin(&sondes, SONDE_VERROU, t1);
         sem_post(mutex);
         sem_post(places_libres);
+        // Horodatage du producteur : même horloge (CLOCK_MONOTONIC) pour tous les processus
+        if (mesurer && item.depose_ns != 0) sonde_fin(&sondes, SONDE_TRANSFERT, item.depose_ns);
 
         sleep(1);
     }
 
+    journal_arreter();
     printf("\n[Consommateur] Fin.\n");
+    attente_rapport(&attente, "Consommateur");
+    if (mesurer) sonde_afficher(&sondes);
 
     munmap(partagee, sizeof(MemoirePartagee));
     sem_close(places_libres);
     sem_close(items_existants);
     sem_close(mutex);
 
-    close(fd_fifo);
-    unlink(FIFO_CONSO);
+    recepteur_fermer(&tube, FIFO_CONSO);
 
     return 0;
 
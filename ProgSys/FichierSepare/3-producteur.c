@@ -8,7 +8,12 @@
 #include <signal.h>     // Gestion signaux
 #include <string.h>
 #include <errno.h>      // Gestion erreurs (EINTR, EAGAIN)
+#include <getopt.h>     // Lecture des options -m -j -W
 #include "3-common.h"
+#include "../Outils/sonde.h" // Histogrammes de latence (option -m, affichés sur SIGUSR1)
+#include "../Outils/journal.h" // Traces hors section critique (option -j)
+#include "../Outils/attente.h" // Stratégie d'attente (option -W)
+#include "../Outils/controle.h" // Commandes du communicant en trames
 
 // Variable globale modifiée par le handler de signal (interruption).
 int stop = 0;
@@ -18,7 +23,35 @@ void handler(int sig) {
     stop = 1;
 }
 
-int main() {
+// Usage : ./3-producteur [-m] [-j niveau] [-W strategie]
+//   -m : mesure chaque attente et chaque détention du verrou ; les messages
+//        sont horodatés pour que le consommateur (lui aussi lancé avec -m)
+//        mesure le transfert complet. "kill -USR1 <pid>" affiche les histogrammes.
+//   -j : traces (0 = aucune, 1 = commandes reçues, 2 = chaque message, par défaut),
+//        écrites par un thread de journal : plus aucun printf sous le verrou.
+//   -W : attente d'une place libre (bloque, spin, cede, adapte ; "bloque" par défaut).
+//        Le bilan (attentes résolues en boucle, endormissements) est affiché à l'arrêt.
+int main(int argc, char *argv[]) {
+    int mesurer = 0;
+    int niveau = JOURNAL_TRACE;
+    int strategie = ATTENTE_BLOQUE;
+    int opt;
+    while ((opt = getopt(argc, argv, "mj:W:")) != -1) {
+        if (opt == 'm') mesurer = 1;
+        else if (opt == 'j') niveau = atoi(optarg);
+        else if (opt == 'W') {
+            if ((strategie = attente_lire(optarg)) == -1) {
+                fprintf(stderr, "Option -W : bloque, spin, cede ou adapte\n");
+                exit(1);
+            }
+        }
+        else exit(1);
+    }
+    Attente attente;
+    attente_init(&attente, strategie);
+    Sondes sondes;
+    sondes_init(&sondes, "Producteur", mesurer);
+
     // =================================================================
     // 1. CONFIGURATION DES SIGNAUX
     // =================================================================
@@ -27,6 +60,7 @@ int main() {
     
     // Interception de Ctrl+C
     sigaction(SIGINT, &psa, NULL);
+    sonde_installer();
 
     // =================================================================
     // 2. INITIALISATION MÉMOIRE PARTAGÉE (COTE CRÉATEUR)
@@ -58,20 +92,18 @@ int main() {
     // =================================================================
     // 3. MISE EN PLACE DU TUBE NOMMÉ (FIFO)
     // =================================================================
-    // mkfifo : Crée un fichier spécial de type FIFO (First In, First Out)
-    // qui servira de canal de communication unidirectionnel.
-    mkfifo(FIFO_PROD, 0666);
-
-    // OUVERTURE NON-BLOQUANTE (CRITIQUE)
-    // O_NONBLOCK : Permet d'ouvrir le tube même si aucun écrivain n'est connecté.
-    // De plus, les futures lectures (read) retourneront immédiatement s'il n'y a rien à lire,
-    // au lieu de bloquer le programme.
-    int fd_fifo = open(FIFO_PROD, O_RDONLY | O_NONBLOCK);
-    if (fd_fifo == -1) {
+    // recepteur_ouvrir crée le tube (mkfifo) et l'ouvre en NON-BLOQUANT : les
+    // lectures retournent immédiatement s'il n'y a rien à lire, au lieu de
+    // bloquer le programme. Les commandes arrivent en trames (cf. controle.h).
+    Recepteur tube;
+    if (recepteur_ouvrir(&tube, FIFO_PROD) == -1) {
         perror("Avertissement : Erreur ouverture FIFO");
     }
 
     printf("--- Producteur V3 (Pilotable) Démarré ---\n");
+    fflush(stdout);     // Avant que le thread de journal n'écrive à son tour
+    if (journal_demarrer(niveau) == -1) perror("Avertissement : thread de journal");
+    journal_rejoindre();    // Canal pris ici, pas sous le verrou de la zone
 
     int k = 0;
     char message_actuel[TAILLE_MSG];
@@ -79,44 +111,52 @@ int main() {
 
     // BOUCLE PRINCIPALE
     while (!stop) {
+        sonde_verifier(&sondes);
+
         // A. LECTURE NON-BLOQUANTE DU TUBE
-        // On vérifie s'il y a un message du communicant.
-        char buffer_cmd[128];
-        ssize_t octets_lus = read(fd_fifo, buffer_cmd, sizeof(buffer_cmd));
-        
-        if (octets_lus > 0) {
-            // Lecture réussie !
-            printf("\n[COMMANDE REÇUE] : '%s'\n", buffer_cmd);
+        // On traite TOUTES les commandes arrivées : un seul read() peut en apporter plusieurs.
+        char buffer_cmd[CONTROLE_MAX];
+        while (recepteur_lire(&tube, buffer_cmd, sizeof(buffer_cmd))) {
+            journal_ecrire(JOURNAL_INFO, "\n[COMMANDE REÇUE] : '%s'\n", buffer_cmd, 0);
             
             if (strcmp(buffer_cmd, "stop") == 0) {
-                printf("Ordre d'arrêt reçu via le tube.\n");
+                journal_ecrire(JOURNAL_INFO, "Ordre d'arrêt reçu via le tube.\n", NULL, 0);
                 stop = 1;
-                break; // On sort de la boucle immédiatement
+                break;
             } else {
                 // Mise à jour du message à produire
                 strncpy(message_actuel, buffer_cmd, TAILLE_MSG);
                 message_actuel[TAILLE_MSG - 1] = '\0'; // Sécurité débordement
             }
         }
-        // Si read retourne -1 avec errno==EAGAIN, c'est normal (tube vide), on continue.
+        if (stop) break; // On sort de la boucle immédiatement
+        // Rien de reçu (tube vide) : c'est normal, on continue.
 
         // B. PRODUCTION NORMALE
         Donnee item;
-        snprintf(item.texte, TAILLE_MSG, "%s-%d", message_actuel, k++);
+        uint64_t t0 = sonde_debut(&sondes);
 
         // Attente d'une place libre
-        if (sem_wait(places_libres) == -1) {
+        if (attente_sem(&attente, places_libres, &stop) == -1) {
             // Si interrompu par Ctrl+C, on arrête
             if (stop) break;
             // Si interrompu par un autre signal, on recommence
             if (errno == EINTR) continue;
         }
+        sonde_fin(&sondes, SONDE_ATTENTE, t0);
+
+        // Numéroté seulement une fois la place obtenue : une attente
+        // interrompue (SIGUSR1, sans SA_RESTART) ne saute aucun numéro.
+        snprintf(item.texte, TAILLE_MSG, "%s-%d", message_actuel, k++);
+        item.depose_ns = t0;
 
         // Section Critique
         sem_wait(mutex);
+        uint64_t t1 = sonde_debut(&sondes);
         partagee->tab[partagee->i] = item;
-        printf("-> Prod : Ecrit '%s' (idx %d)\n", item.texte, partagee->i);
+        journal_ecrire(JOURNAL_TRACE, "-> Prod : Ecrit '%s' (idx %d)\n", item.texte, partagee->i);
         partagee->i = (partagee->i + 1) % N;
+        sonde_fin(&sondes, SONDE_VERROU, t1);
         sem_post(mutex);
         
         // Signalement nouvel item
@@ -128,7 +168,10 @@ int main() {
     // =================================================================
     // 4. NETTOYAGE COMPLET (Rôle du Créateur)
     // =================================================================
+    journal_arreter();  // Dernières traces, avant le bilan
     printf("\n[Producteur] Fin. Nettoyage des ressources système.\n");
+    attente_rapport(&attente, "Producteur");
+    if (mesurer) sonde_afficher(&sondes);
 
     munmap(partagee, sizeof(MemoirePartagee));
     sem_close(places_libres);
@@ -143,8 +186,7 @@ int main() {
     sem_unlink(SEM_MUTEX);
     
     // Fermeture et destruction du tube
-    close(fd_fifo);
-    unlink(FIFO_PROD); 
+    recepteur_fermer(&tube, FIFO_PROD);
 
     return 0;
 
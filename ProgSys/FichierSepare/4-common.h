@@ -0,0 +1,677 @@
+#ifndef COMMON_H
+#define COMMON_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdatomic.h>
+#include "../Outils/futex.h"   // Parking (futex) placé DANS le segment partagé
+#include "../Outils/memoire.h" // Pages énormes, pré-chargement, mlock
+#include "../Outils/histo.h"   // horloge_ns (lecture espacée des tubes)
+#include "../Outils/controle.h" // Trames de commande sur les tubes
+
+// --- PARAMÈTRES DU TAMPON ---
+// Ce ne sont plus que des valeurs PAR DÉFAUT : la géométrie réelle est choisie au
+// lancement du producteur (arguments) et inscrite dans l'en-tête du segment.
+#define CAPACITE_DEFAUT 16        // Nombre de cases (arrondi à une puissance de 2)
+#define TAILLE_CASE_DEFAUT 64     // Taille en octets d'une case (message + '\0')
+#define CAPACITE_MAX (1UL << 24)  // Garde-fous contre une saisie aberrante
+#define TAILLE_CASE_MIN 8
+#define TAILLE_CASE_MAX 65536
+#define TAILLE_LIGNE 64           // Taille d'une ligne de cache (octets)
+
+// "Signature" écrite au début du segment : permet au consommateur de vérifier
+// qu'il s'attache bien à un anneau V4 complètement initialisé.
+#define MAGIQUE_V4 0x34524E41u    // "ANR4" en mémoire
+#define VERSION_LAYOUT 6          // 2 : boîtes aux lettres ; 3 : accusé de lecture ; 4 : statistiques ; 5 : diffusion ; 6 : accusé par lecteur
+
+// --- IDENTIFIANTS DES RESSOURCES PARTAGÉES (VERSION 4) ---
+// Plus aucun sémaphore nommé : toute la synchronisation vit dans le segment.
+#define SHM_NAME "/mon_shm_v4"             // Nom de la zone de mémoire partagée
+// Même segment, mais sur hugetlbfs (option MEM_HUGE) : /dev/shm ne sait pas
+// fournir de vraies pages énormes, il faut un fichier sur un montage hugetlbfs.
+#define HUGE_NAME CHEMIN_HUGETLBFS SHM_NAME
+
+// --- IDENTIFIANTS DES TUBES NOMMÉS (FIFOs) ---
+// Mêmes chemins et mêmes TRAMES (Outils/controle.h) que la V3 et la V5 :
+// le même communicant pilote toutes ces versions.
+#define FIFO_PROD "/tmp/fifo_prod_v3"      // Boîte aux lettres du Producteur
+#define FIFO_CONSO "/tmp/fifo_conso_v3"    // Boîte aux lettres du Consommateur
+
+// Les tubes ne sont plus qu'un secours (communicant d'une ancienne version) :
+// on ne les lit qu'une fois par PERIODE_TUBE_NS, et non plus à chaque message.
+#define PERIODE_TUBE_NS 1000000000ULL
+#define PAUSE_DEMO_NS 1000000000ULL    // Rythme de démonstration : un message par seconde
+
+// --- BOÎTE AUX LETTRES DANS LE SEGMENT ---
+// Remplace le read() non bloquant du tube fait à CHAQUE tour de boucle (un appel
+// système par message). Le communicant écrit ici, et la boucle chaude n'a plus
+// qu'à relire 'sequence' : UN chargement mémoire tant que rien ne change.
+//
+// 'sequence' est un "seqlock" :
+//   - impaire : un communicant est en train d'écrire (lecture à refaire),
+//   - paire   : contenu stable ; elle augmente de 2 à chaque commande et sert
+//               donc aussi de numéro de GÉNÉRATION (nouvelle commande ou pas ?).
+// 'acquittee' : dernière génération relevée par le destinataire. Un communicant
+// n'écrit une nouvelle commande qu'une fois la précédente relevée : la boîte
+// n'a qu'une place, mais aucune commande n'est écrasée avant d'avoir été lue.
+// En diffusion, tous les lecteurs partagent boite_conso : chacun acquitte
+// dans SON curseur, et c'est le plus lent qui libère la place.
+#define CMD_AUCUNE  0
+#define CMD_MESSAGE 1   // Nouveau texte (message_actuel du producteur, ou affichage)
+#define CMD_STOP    2   // Ordre d'arrêt
+#define TAILLE_BOITE 128
+
+typedef struct {
+    _Atomic uint32_t sequence;
+    _Atomic uint32_t acquittee;
+    uint32_t commande;
+    char message[TAILLE_BOITE];
+} BoiteAuxLettres;
+
+// --- STATISTIQUES EN DIRECT ---
+// Compteurs tenus par chaque côté DANS le segment : un observateur (moniteur.c)
+// s'attache en lecture seule et voit débits, retard et blocages sans toucher
+// aux processus ni lire leur sortie.
+// Un seul écrivain par bloc (le côté concerné) : une incrémentation est un
+// simple chargement + rangement (pas d'instruction atomique verrouillée), et
+// chaque bloc a sa ligne de cache pour ne pas gêner l'autre côté.
+typedef struct {
+    _Atomic uint64_t messages;      // Cases validées (producteur) ou libérées (consommateur)
+    _Atomic uint64_t octets;        // Octets utiles de ces messages
+    _Atomic uint64_t blocages;      // Fois où l'anneau était plein (producteur) / vide (consommateur)
+    _Atomic uint64_t blocage_ns;    // Temps total passé bloqué
+} Statistiques;
+
+// Ajoute 'n' à un compteur dont on est le SEUL écrivain.
+static inline void stat_ajouter(_Atomic uint64_t *compteur, uint64_t n) {
+    atomic_store_explicit(compteur, atomic_load_explicit(compteur, memory_order_relaxed) + n,
+                          memory_order_relaxed);
+}
+
+// --- DIFFUSION : PLUSIEURS LECTEURS INDÉPENDANTS ---
+// Avec un seul index de lecture ('queue'), deux consommateurs se PARTAGENT le
+// flux : chaque message n'est vu que par l'un d'eux. En mode diffusion (option
+// SEG_DIFFUSION du producteur), chaque consommateur inscrit son propre CURSEUR
+// dans le segment et lit TOUS les messages, sans aucune copie. Le producteur
+// ne réécrit une case que lorsque le lecteur le plus lent l'a dépassée
+// ("barrière de séquence" du disrupteur) : 'queue' n'est plus utilisé.
+// Sans lecteur inscrit, le producteur n'est pas freiné (personne n'attend ses
+// messages) ; un lecteur qui s'inscrit part des messages publiés après lui.
+#define SEG_DIFFUSION 0x100       // Option de segment_creer (à côté des MEM_*)
+#define LECTEURS_MAX 8
+#define CURSEUR_LIBRE 0
+#define CURSEUR_RESERVE 1         // En cours d'inscription
+#define CURSEUR_ACTIF 2
+#define TAILLE_NOM 16
+
+// Une ligne de cache par lecteur : il est le SEUL à écrire dans la sienne.
+typedef struct {
+    _Atomic uint32_t etat;          // CURSEUR_LIBRE / RESERVE / ACTIF
+    int32_t pid;                    // Pour récupérer la place d'un lecteur disparu (kill -9)
+    _Atomic uint32_t acquittee;     // Dernière génération de boite_conso relevée par CE lecteur
+    _Atomic unsigned long position; // Prochaine séquence que CE lecteur lira
+    char nom[TAILLE_NOM];           // "archiveur", "moniteur"... (affichage)
+    Statistiques stats;             // Compteurs de CE lecteur
+} Curseur;
+
+// --- STRUCTURE DE LA MÉMOIRE PARTAGÉE (Layout V4 : anneau sans verrou) ---
+// 1. Un EN-TÊTE qui décrit le segment (écrit une seule fois par le créateur).
+//    Un consommateur n'a plus besoin d'être recompilé : il lit la géométrie ici.
+// 2. Les index et les mots futex.
+//    'tete' et 'queue' sont des numéros de séquence qui ne reviennent jamais à 0.
+//      - tete  : écrit par le Producteur (prochaine séquence à écrire)
+//      - queue : écrit par le Consommateur (prochaine séquence à lire)
+//    Nombre d'items présents = tete - queue.
+//    Case utilisée = sequence & masque (capacité en puissance de 2 : un ET binaire
+//    remplace le modulo, qui coûte une division).
+// 3. Une boîte aux lettres par destinataire, écrite par le communicant.
+// 4. Les statistiques de chaque côté (lues par le moniteur).
+// 5. Les curseurs des lecteurs (mode diffusion seulement).
+// 6. Les cases elles-mêmes, en fin de segment (tableau de taille variable).
+//
+// _Alignas(TAILLE_LIGNE) : chaque champ chaud a sa propre ligne de cache.
+typedef struct {
+    // --- En-tête descriptif ---
+    _Atomic uint32_t magique;   // Écrit EN DERNIER : segment prêt
+    uint32_t version;           // Version du layout
+    uint64_t capacite;          // Nombre de cases (puissance de 2)
+    uint64_t masque;            // capacite - 1
+    uint64_t taille_case;       // Octets par case
+    uint64_t taille_totale;     // Taille du segment (= argument de ftruncate)
+    uint64_t diffusion;         // 1 : chaque lecteur a son curseur et lit tout
+
+    // --- Synchronisation ---
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long tete;
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long queue;
+    _Alignas(TAILLE_LIGNE) Parking parking_prod;   // Le producteur dort ici si c'est plein
+    _Alignas(TAILLE_LIGNE) Parking parking_conso;  // Le consommateur dort ici si c'est vide
+
+    // --- Commandes du communicant ---
+    _Alignas(TAILLE_LIGNE) BoiteAuxLettres boite_prod;
+    _Alignas(TAILLE_LIGNE) BoiteAuxLettres boite_conso;
+
+    // --- Statistiques (une ligne de cache par côté) ---
+    _Alignas(TAILLE_LIGNE) Statistiques stats_prod;
+    _Alignas(TAILLE_LIGNE) Statistiques stats_conso;
+
+    // --- Lecteurs (mode diffusion) ---
+    _Alignas(TAILLE_LIGNE) Curseur curseurs[LECTEURS_MAX];
+
+    // --- Données ---
+    _Alignas(TAILLE_LIGNE) unsigned char cases[];  // capacite * taille_case octets
+} MemoirePartagee;
+
+// Plus petite puissance de 2 supérieure ou égale à 'n'.
+static inline uint64_t puissance2_sup(uint64_t n) {
+    uint64_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// Taille totale du segment pour une géométrie donnée.
+static inline size_t taille_segment(uint64_t capacite, uint64_t taille_case) {
+    return sizeof(MemoirePartagee) + capacite * taille_case;
+}
+
+// =================================================================
+// CRÉATION / ATTACHEMENT DU SEGMENT
+// =================================================================
+
+// Producteur : crée le segment à la bonne taille et remplit l'en-tête.
+// 'capacite' est arrondie à la puissance de 2 supérieure.
+// 'options' (MEM_HUGE, MEM_PREFAULT, MEM_VERROU) choisit la projection ; '*proj'
+// reçoit ce qui a réellement été obtenu.
+// Renvoie NULL en cas d'erreur (message déjà affiché).
+static inline MemoirePartagee *segment_creer(uint64_t capacite, uint64_t taille_case,
+                                             int options, Projection *proj) {
+    capacite = puissance2_sup(capacite);
+    size_t taille = taille_segment(capacite, taille_case);
+    int enorme = 0;
+
+    // 1. Pages énormes demandées : fichier sur hugetlbfs, taille arrondie à 2 Mo.
+    //    Le mmap échoue (ENOMEM) si aucune page énorme n'est réservée : on se replie.
+    if (options & MEM_HUGE) {
+        int fd = open(HUGE_NAME, O_CREAT | O_RDWR, 0666);
+        if (fd != -1) {
+            size_t t = arrondir(taille, taille_page_enorme());
+            if (ftruncate(fd, t) == 0 && projeter_fd(proj, fd, t, options, 1) == 0) {
+                enorme = 1;
+                taille = t;
+                shm_unlink(SHM_NAME); // Un consommateur ne doit pas trouver un vieux segment
+            }
+            close(fd);
+        }
+    }
+
+    // 2. Sinon, segment POSIX classique dans /dev/shm.
+    if (!enorme) {
+        // Le fichier hugetlbfs d'une exécution -H précédente (arrêt brutal, ou
+        // repli ci-dessus) doit disparaître : consommateurs, moniteur et
+        // communicant le cherchent EN PREMIER et s'attacheraient à un segment mort.
+        unlink(HUGE_NAME);
+        int fd_shm = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
+        if (fd_shm == -1) {
+            perror("Erreur shm_open");
+            return NULL;
+        }
+        // ftruncate dimensionne le segment selon la géométrie CHOISIE au lancement.
+        if (ftruncate(fd_shm, taille) == -1) {
+            perror("Erreur ftruncate");
+            close(fd_shm);
+            return NULL;
+        }
+        int r = projeter_fd(proj, fd_shm, taille, options, 0);
+        close(fd_shm);
+        if (r == -1) {
+            perror("Erreur mmap");
+            return NULL;
+        }
+    }
+    MemoirePartagee *shm = proj->adresse;
+
+    // Remise à zéro de l'en-tête, des séquences ET des mots futex, même si un
+    // ancien segment traînait dans /dev/shm après un arrêt brutal.
+    memset(shm, 0, sizeof(MemoirePartagee));
+    shm->version = VERSION_LAYOUT;
+    shm->capacite = capacite;
+    shm->masque = capacite - 1;
+    shm->taille_case = taille_case;
+    shm->taille_totale = taille;
+    shm->diffusion = (options & SEG_DIFFUSION) != 0;
+    // release : tout l'en-tête est visible AVANT la signature.
+    atomic_store_explicit(&shm->magique, MAGIQUE_V4, memory_order_release);
+    return shm;
+}
+
+// Consommateur : s'attache au segment existant et lit sa géométrie dans l'en-tête.
+// Le segment est cherché sur hugetlbfs puis dans /dev/shm.
+// 'options' : seuls MEM_PREFAULT, MEM_VERROU et MEM_LECTURE (observateur) ont un
+// sens ici (le type de pages a été choisi par le créateur).
+// Renvoie NULL si le segment est absent ou n'est pas (encore) un anneau V4 valide.
+static inline MemoirePartagee *segment_attacher(int options, Projection *proj) {
+    int enorme = 1;
+    int mode = (options & MEM_LECTURE) ? O_RDONLY : O_RDWR;
+    int fd_shm = open(HUGE_NAME, mode);
+    if (fd_shm == -1) {
+        enorme = 0;
+        fd_shm = shm_open(SHM_NAME, mode, 0666);
+    }
+    if (fd_shm == -1) {
+        perror("Lancez le producteur avant");
+        return NULL;
+    }
+    // La taille réelle du segment est connue du noyau : pas besoin de la deviner.
+    struct stat st;
+    if (fstat(fd_shm, &st) == -1 || (size_t) st.st_size < sizeof(MemoirePartagee)) {
+        fprintf(stderr, "Segment %s vide ou trop petit.\n", SHM_NAME);
+        close(fd_shm);
+        return NULL;
+    }
+    int r = projeter_fd(proj, fd_shm, st.st_size, options & ~MEM_HUGE, enorme);
+    close(fd_shm);
+    if (r == -1) {
+        perror("Erreur mmap");
+        return NULL;
+    }
+    MemoirePartagee *shm = proj->adresse;
+    if (atomic_load_explicit(&shm->magique, memory_order_acquire) != MAGIQUE_V4
+        || shm->version != VERSION_LAYOUT
+        || shm->taille_totale != (uint64_t) st.st_size) {
+        fprintf(stderr, "Segment %s non reconnu (producteur V4 pas prêt ?).\n", SHM_NAME);
+        projection_liberer(proj);
+        return NULL;
+    }
+    return shm;
+}
+
+// Détache le segment.
+static inline void segment_detacher(Projection *proj) {
+    projection_liberer(proj);
+}
+
+// Producteur, à l'arrêt : efface la signature. Un communicant encore attaché
+// (session persistante) voit ainsi que le segment est mort et se ré-attache.
+static inline void segment_fermer(MemoirePartagee *shm) {
+    atomic_store_explicit(&shm->magique, 0, memory_order_release);
+}
+
+// Renvoie 1 si un segment V4 existe (sans message d'erreur, contrairement à segment_attacher).
+static inline int segment_existe(void) {
+    int fd = open(HUGE_NAME, O_RDONLY);
+    if (fd == -1) fd = shm_open(SHM_NAME, O_RDONLY, 0);
+    if (fd == -1) return 0;
+    close(fd);
+    return 1;
+}
+
+// Producteur : supprime le segment, où qu'il ait été créé.
+static inline void segment_supprimer(void) {
+    shm_unlink(SHM_NAME);
+    unlink(HUGE_NAME);
+}
+
+// =================================================================
+// API "ZÉRO COPIE" : on travaille DIRECTEMENT dans la case partagée
+// =================================================================
+// Producteur : d = reserver_case(...)  -> on formate dans d (taille_case octets) -> valider_case(...)
+// Consommateur : d = lire_case(...)    -> on traite d sur place                -> liberer_case(...)
+// Entre reserver/valider (ou lire/liberer), la case appartient à l'appelant seul :
+// l'autre côté ne la touchera pas tant que l'index n'a pas été publié.
+
+// État LOCAL d'un côté (pas dans le segment) : ses propres séquences, une copie
+// de l'index de l'autre côté (relue seulement quand le tampon semble plein/vide)
+// et une copie de la géométrie (immuable : inutile de la relire dans le segment).
+typedef struct {
+    MemoirePartagee *shm;
+    unsigned long position;     // tete (Producteur) ou queue (Consommateur)
+    unsigned long autre_connue; // Dernière valeur lue de l'index de l'autre côté
+    unsigned long capacite;
+    unsigned long masque;
+    unsigned long taille_case;
+    BoiteAuxLettres *boite;     // Notre boîte aux lettres dans le segment
+    uint32_t generation_vue;    // Dernière génération de la boîte déjà traitée
+    Statistiques *stats;        // Nos compteurs dans le segment
+    int producteur;
+    int diffusion;              // Copie de shm->diffusion
+    Curseur *curseur;           // Diffusion : notre curseur (lecteur inscrit), sinon NULL
+} Cote;
+
+// Diffusion : position du lecteur ACTIF le plus lent ('tete' s'il n'y en a aucun).
+// C'est la "queue" vue par le producteur : il ne peut pas la dépasser de plus
+// d'un tour d'anneau.
+static inline unsigned long curseur_minimum(MemoirePartagee *shm, unsigned long tete) {
+    unsigned long minimum = tete;
+    for (int k = 0; k < LECTEURS_MAX; k++) {
+        Curseur *l = &shm->curseurs[k];
+        if (atomic_load_explicit(&l->etat, memory_order_seq_cst) != CURSEUR_ACTIF) continue;
+        unsigned long p = atomic_load_explicit(&l->position, memory_order_acquire);
+        if ((long) (p - minimum) < 0) minimum = p;
+    }
+    return minimum;
+}
+
+// Index de l'autre côté, tel que le voit 'c' : 'tete' pour un consommateur ;
+// 'queue' (ou le lecteur le plus lent, en diffusion) pour le producteur.
+static inline unsigned long index_autre(const Cote *c) {
+    MemoirePartagee *shm = c->shm;
+    if (!c->producteur) return atomic_load_explicit(&shm->tete, memory_order_acquire);
+    if (c->diffusion) return curseur_minimum(shm, c->position);
+    return atomic_load_explicit(&shm->queue, memory_order_acquire);
+}
+
+// Attache un côté au segment en reprenant les index qui s'y trouvent.
+static inline void cote_attacher(Cote *c, MemoirePartagee *shm, int producteur) {
+    c->shm = shm;
+    c->capacite = shm->capacite;
+    c->masque = shm->masque;
+    c->taille_case = shm->taille_case;
+    c->boite = producteur ? &shm->boite_prod : &shm->boite_conso;
+    c->stats = producteur ? &shm->stats_prod : &shm->stats_conso;
+    c->producteur = producteur;
+    c->diffusion = (int) shm->diffusion;
+    c->curseur = NULL;
+    // Les commandes envoyées AVANT notre arrivée sont ignorées (comme avec un tube).
+    c->generation_vue = atomic_load_explicit(&c->boite->sequence, memory_order_acquire) & ~1u;
+    atomic_store_explicit(&c->boite->acquittee, c->generation_vue, memory_order_release);
+    unsigned long t = atomic_load_explicit(&shm->tete, memory_order_acquire);
+    unsigned long q = atomic_load_explicit(&shm->queue, memory_order_acquire);
+    c->position = producteur ? t : q;
+    c->autre_connue = producteur ? q : t;
+    if (producteur && c->diffusion) c->autre_connue = curseur_minimum(shm, t);
+}
+
+// Diffusion : inscrit le consommateur 'c' sous le nom 'nom'. Il lira tous les
+// messages publiés à partir de maintenant. Renvoie 0, ou -1 si les
+// LECTEURS_MAX curseurs sont pris.
+static inline int curseur_inscrire(Cote *c, const char *nom) {
+    MemoirePartagee *shm = c->shm;
+    for (int k = 0; k < LECTEURS_MAX; k++) {
+        Curseur *l = &shm->curseurs[k];
+        uint32_t libre = CURSEUR_LIBRE;
+        if (!atomic_compare_exchange_strong(&l->etat, &libre, CURSEUR_RESERVE)) continue;
+        l->pid = (int32_t) getpid();
+        snprintf(l->nom, TAILLE_NOM, "%s", nom);
+        memset(&l->stats, 0, sizeof(l->stats));
+        atomic_store(&l->acquittee, c->generation_vue);
+        atomic_store(&l->position, atomic_load(&shm->tete));
+        atomic_store_explicit(&l->etat, CURSEUR_ACTIF, memory_order_seq_cst);
+        // 'tete' relue APRÈS l'inscription : le producteur, qui relit les
+        // curseurs avant de dépasser son ancienne barrière (toujours <= tete),
+        // ne peut plus réécrire une case à partir de celle-ci.
+        unsigned long t = atomic_load_explicit(&shm->tete, memory_order_seq_cst);
+        atomic_store_explicit(&l->position, t, memory_order_release);
+        c->curseur = l;
+        c->stats = &l->stats;
+        c->position = t;
+        c->autre_connue = t;
+        return 0;
+    }
+    return -1;
+}
+
+// Diffusion : rend le curseur (le producteur n'attend plus ce lecteur).
+static inline void curseur_liberer(Cote *c) {
+    if (c->curseur == NULL) return;
+    atomic_store_explicit(&c->curseur->etat, CURSEUR_LIBRE, memory_order_release);
+    parking_reveiller(&c->shm->parking_prod, 0);
+    c->curseur = NULL;
+}
+
+// Diffusion : libère les curseurs des lecteurs morts sans se désinscrire
+// (kill -9), qui bloqueraient le producteur pour toujours. Renvoie leur nombre.
+static inline int curseurs_nettoyer(MemoirePartagee *shm) {
+    int n = 0;
+    for (int k = 0; k < LECTEURS_MAX; k++) {
+        Curseur *l = &shm->curseurs[k];
+        if (atomic_load(&l->etat) == CURSEUR_ACTIF && kill(l->pid, 0) == -1 && errno == ESRCH) {
+            atomic_store(&l->etat, CURSEUR_LIBRE);
+            n++;
+        }
+    }
+    return n;
+}
+
+// Une commande non encore traitée attend-elle dans notre boîte ? (UN chargement)
+// Une séquence impaire ne compte pas : l'écriture n'est pas finie (le
+// communicant secouera le parking en la finissant), ou le communicant est mort
+// au milieu, et il ne faut pas que chaque attente s'arrête net pour ça.
+static inline int boite_nouvelle(const Cote *c) {
+    uint32_t s = atomic_load_explicit(&c->boite->sequence, memory_order_seq_cst);
+    return s != c->generation_vue && !(s & 1);
+}
+
+// Comme parking_attendre, mais une nouvelle commande dans la boîte interrompt
+// aussi l'attente (le communicant "secoue" le parking après avoir écrit).
+// En diffusion, le producteur ne dort qu'une seconde à la fois : il vérifie
+// ensuite qu'aucun des lecteurs qui le freinent n'a disparu.
+static inline void cote_attendre(Cote *c, Parking *p, const volatile sig_atomic_t *stop) {
+    unsigned int v = parking_preparer(p);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (index_autre(c) == c->autre_connue && !*stop && !boite_nouvelle(c)) {
+        if (c->producteur && c->diffusion) {
+            if (futex_attendre_delai(&p->signal, v, 1000000000ULL, 0) == -1 && errno == ETIMEDOUT)
+                curseurs_nettoyer(c->shm);
+            parking_annuler(p);
+        } else {
+            parking_dormir(p, v, 0);
+        }
+    } else {
+        parking_annuler(p);
+    }
+}
+
+// Pause jusqu'à l'heure 'fin' (horloge_ns), écourtée dès qu'une commande arrive
+// dans la boîte. Renvoie 1 si une commande attend (l'appelant la relève puis
+// reprend sa pause), 0 si l'heure est passée ou si '*stop' a été levé.
+// Remplace le sleep(1) de démonstration : pendant un sleep, la boîte n'était
+// relevée qu'une fois par seconde, et un script de commandes attendait d'autant.
+static inline int cote_pause(Cote *c, Parking *p, uint64_t fin, const volatile sig_atomic_t *stop) {
+    for (;;) {
+        if (boite_nouvelle(c)) return 1;
+        uint64_t maintenant = horloge_ns();
+        if (*stop || maintenant >= fin) return 0;
+        unsigned int v = parking_preparer(p);
+        if (!boite_nouvelle(c) && !*stop) {
+            futex_attendre_delai(&p->signal, v, fin - maintenant, 0);
+        }
+        parking_annuler(p);
+    }
+}
+
+// Fin d'un blocage commencé à l'heure 'debut' (0 : il n'y en a pas eu).
+// L'horloge n'est lue que si l'on a vraiment dû attendre : rien sur le chemin rapide.
+static inline void stats_blocage(Statistiques *s, uint64_t debut) {
+    if (debut == 0) return;
+    stat_ajouter(&s->blocages, 1);
+    stat_ajouter(&s->blocage_ns, horloge_ns() - debut);
+}
+
+// Producteur : attend une case libre (seulement si VRAIMENT plein) et la renvoie.
+// Renvoie NULL si '*stop' a été levé, ou si une commande est arrivée dans la
+// boîte aux lettres, pendant l'attente (l'appelant traite la commande et recommence).
+static inline char *reserver_case(Cote *c, const volatile sig_atomic_t *stop) {
+    MemoirePartagee *shm = c->shm;
+    uint64_t debut = 0;
+    while (!*stop && c->position - c->autre_connue >= c->capacite) {
+        if (boite_nouvelle(c)) break;
+        c->autre_connue = index_autre(c);
+        if (c->position - c->autre_connue >= c->capacite) {
+            if (debut == 0) debut = horloge_ns();
+            cote_attendre(c, &shm->parking_prod, stop);
+        }
+    }
+    stats_blocage(c->stats, debut);
+    if (*stop || c->position - c->autre_connue >= c->capacite) return NULL;
+    return (char *) &shm->cases[(c->position & c->masque) * c->taille_case];
+}
+
+// Producteur : publie la case réservée (release) et réveille le consommateur S'IL dort
+// (en diffusion : TOUS les lecteurs endormis, chacun attend ce message).
+// 'octets' : taille utile du message écrit (pour les statistiques).
+static inline void valider_case(Cote *c, size_t octets) {
+    c->position++;
+    atomic_store_explicit(&c->shm->tete, c->position, memory_order_release);
+    if (c->diffusion) {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&c->shm->parking_conso.endormi, memory_order_relaxed) > 0)
+            parking_secouer(&c->shm->parking_conso, 0);
+    } else {
+        parking_reveiller(&c->shm->parking_conso, 0);
+    }
+    stat_ajouter(&c->stats->messages, 1);
+    stat_ajouter(&c->stats->octets, octets);
+}
+
+// Consommateur : attend une case pleine (seulement si VRAIMENT vide) et la renvoie.
+// Renvoie NULL si '*stop' a été levé, ou si une commande est arrivée, pendant l'attente.
+static inline const char *lire_case(Cote *c, const volatile sig_atomic_t *stop) {
+    MemoirePartagee *shm = c->shm;
+    uint64_t debut = 0;
+    while (!*stop && c->position == c->autre_connue) {
+        if (boite_nouvelle(c)) break;
+        c->autre_connue = index_autre(c);
+        if (c->position == c->autre_connue) {
+            if (debut == 0) debut = horloge_ns();
+            cote_attendre(c, &shm->parking_conso, stop);
+        }
+    }
+    stats_blocage(c->stats, debut);
+    if (*stop || c->position == c->autre_connue) return NULL;
+    return (char *) &shm->cases[(c->position & c->masque) * c->taille_case];
+}
+
+// Consommateur : rend la case au producteur (release) et le réveille S'IL dort.
+// En diffusion, seul NOTRE curseur avance : la case n'est réellement libre
+// que lorsque tous les lecteurs l'ont passée.
+// 'octets' : taille utile du message lu (pour les statistiques).
+static inline void liberer_case(Cote *c, size_t octets) {
+    c->position++;
+    atomic_store_explicit(c->curseur != NULL ? &c->curseur->position : &c->shm->queue,
+                          c->position, memory_order_release);
+    parking_reveiller(&c->shm->parking_prod, 0);
+    stat_ajouter(&c->stats->messages, 1);
+    stat_ajouter(&c->stats->octets, octets);
+}
+
+// =================================================================
+// BOÎTES AUX LETTRES
+// =================================================================
+
+// Destinataire : relève la boîte. Renvoie CMD_AUCUNE si rien de nouveau (cas
+// courant : un seul chargement), sinon la commande, dont le texte est copié
+// dans 'message' ('taille' octets au plus, '\0' compris).
+// Jamais d'attente ici : une écriture en cours (séquence impaire) donne
+// CMD_AUCUNE, et la commande sera relevée au prochain passage. Tourner jusqu'à
+// la fin de l'écriture bloquerait la boucle chaude pour toujours si le
+// communicant est tué entre la prise de la boîte et la publication.
+static inline int boite_lire(Cote *c, char *message, size_t taille) {
+    BoiteAuxLettres *b = c->boite;
+    uint32_t s1 = atomic_load_explicit(&b->sequence, memory_order_acquire);
+    if (s1 == c->generation_vue) return CMD_AUCUNE;
+
+    uint32_t commande;
+    char copie[TAILLE_BOITE];
+    for (;;) {
+        if (s1 & 1) return CMD_AUCUNE;              // Écriture en cours : on repassera
+        commande = b->commande;
+        memcpy(copie, b->message, TAILLE_BOITE);
+        atomic_thread_fence(memory_order_acquire);
+        // Si 'sequence' n'a pas bougé, personne n'a écrit pendant la copie.
+        uint32_t s2 = atomic_load_explicit(&b->sequence, memory_order_relaxed);
+        if (s2 == s1) break;
+        s1 = s2;
+    }
+    c->generation_vue = s1;
+    atomic_store_explicit(c->curseur != NULL ? &c->curseur->acquittee : &b->acquittee,
+                          s1, memory_order_release);    // Place libre pour la suivante
+    copie[TAILLE_BOITE - 1] = '\0';
+    snprintf(message, taille, "%s", copie);
+    return (int) commande;
+}
+
+// Destinataire : prochaine commande en attente, d'abord dans la boîte (un
+// chargement mémoire), sinon dans le tube de secours. Le tube n'est lu qu'une
+// fois par PERIODE_TUBE_NS, sauf s'il reste des trames déjà reçues à découper.
+// À appeler en boucle jusqu'à CMD_AUCUNE pour traiter tout ce qui est arrivé.
+static inline int commande_suivante(Cote *c, Recepteur *tube, uint64_t *prochain_tube,
+                                    char *cmd, size_t taille) {
+    int r = boite_lire(c, cmd, taille);
+    if (r != CMD_AUCUNE) return r;
+    if (tube->rempli == 0) {
+        uint64_t maintenant = horloge_ns();
+        if (maintenant < *prochain_tube) return CMD_AUCUNE;
+        *prochain_tube = maintenant + PERIODE_TUBE_NS;
+    }
+    if (!recepteur_lire(tube, cmd, taille)) return CMD_AUCUNE;
+    return (strcmp(cmd, "stop") == 0) ? CMD_STOP : CMD_MESSAGE;
+}
+
+// Communicant : la génération 's' de la boîte 'b' a-t-elle été relevée ? En
+// diffusion, la boîte du consommateur l'est quand TOUS les lecteurs actifs
+// l'ont vue (sans lecteur, personne n'attend la commande).
+static inline int boite_relevee(MemoirePartagee *shm, BoiteAuxLettres *b, uint32_t s) {
+    if (b != &shm->boite_conso || !shm->diffusion)
+        return atomic_load_explicit(&b->acquittee, memory_order_acquire) == s;
+    for (int k = 0; k < LECTEURS_MAX; k++) {
+        Curseur *l = &shm->curseurs[k];
+        if (atomic_load_explicit(&l->etat, memory_order_acquire) == CURSEUR_ACTIF
+            && atomic_load_explicit(&l->acquittee, memory_order_acquire) != s) return 0;
+    }
+    return 1;
+}
+
+// Communicant : dépose 'texte' ("stop" = ordre d'arrêt) dans la boîte du
+// producteur ('producteur' = 1) ou du consommateur, puis réveille le
+// destinataire s'il dort sur l'anneau pour qu'il relève sa boîte.
+// Attend au plus 'delai_ms' que la commande précédente ait été relevée.
+// Renvoie 0, ou -1 si le délai est écoulé (rien n'a été écrit).
+static inline int boite_poster(MemoirePartagee *shm, int producteur, const char *texte, int delai_ms) {
+    BoiteAuxLettres *b = producteur ? &shm->boite_prod : &shm->boite_conso;
+    uint64_t limite = horloge_ns() + (uint64_t) delai_ms * 1000000ULL;
+
+    // 1. On passe 'sequence' à une valeur impaire (un seul écrivain à la fois),
+    //    seulement quand la commande précédente a été relevée. Le CAS garantit
+    //    qu'aucun autre communicant n'a écrit entre la vérification et la prise.
+    uint32_t s = atomic_load_explicit(&b->sequence, memory_order_relaxed);
+    uint32_t depart = s;
+    for (;;) {
+        if ((s & 1) || !boite_relevee(shm, b, s)) {
+            if (horloge_ns() > limite) {
+                // Restée impaire, à la MÊME valeur, pendant tout le délai : le
+                // communicant qui l'a prise est mort entre les étapes 1 et 3
+                // (Ctrl+C). On reprend la boîte à sa place (s + 2, toujours
+                // impaire : un seul repreneur gagne), sinon plus personne ne
+                // pourrait jamais y écrire.
+                if ((s & 1) && s == depart && atomic_compare_exchange_strong(&b->sequence, &s, s + 2)) {
+                    s++;                    // L'étape 3 publie s + 2 : paire
+                    break;
+                }
+                return -1;
+            }
+            usleep(100);
+            s = atomic_load_explicit(&b->sequence, memory_order_relaxed);
+            continue;
+        }
+        if (atomic_compare_exchange_weak(&b->sequence, &s, s + 1)) break;
+    }
+    atomic_thread_fence(memory_order_release);
+
+    // 2. Contenu
+    b->commande = (strcmp(texte, "stop") == 0) ? CMD_STOP : CMD_MESSAGE;
+    snprintf(b->message, TAILLE_BOITE, "%s", texte);
+
+    // 3. Nouvelle génération (paire) : le contenu devient visible d'un coup.
+    atomic_store_explicit(&b->sequence, s + 2, memory_order_seq_cst);
+    parking_secouer(producteur ? &shm->parking_prod : &shm->parking_conso, 0);
+    return 0;
+}
+
+#endif
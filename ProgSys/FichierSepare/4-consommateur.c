@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>     // Lecture des options -P -L -n
+#include "4-common.h"
+
+volatile sig_atomic_t stop = 0;
+MemoirePartagee* partagee = NULL;
+
+void handler(int sig) {
+    stop = 1;
+    // Si on dort sur le futex "tampon vide", on se secoue pour voir 'stop'.
+    if (partagee != NULL) parking_secouer(&partagee->parking_conso, 0);
+}
+
+// Usage : ./4-consommateur [-P] [-L] [-n nom]
+//   -P : pré-chargement (MAP_POPULATE)   -L : verrouillage (mlock)
+//   -n : nom du lecteur en mode diffusion ("archiveur", "moniteur"...)
+// Le type de pages (normales ou énormes) est imposé par le producteur, ainsi
+// que le mode : si le producteur a été lancé avec -D, chaque consommateur
+// inscrit son curseur et lit tous les messages.
+int main(int argc, char *argv[]) {
+    int options = 0;
+    const char *nom = "conso";
+    int opt;
+    while ((opt = getopt(argc, argv, "PLn:")) != -1) {
+        if (opt == 'P') options |= MEM_PREFAULT;
+        else if (opt == 'L') options |= MEM_VERROU;
+        else if (opt == 'n') nom = optarg;
+        else exit(1);
+    }
+
+    // 1. CONFIGURATION DU SIGNAL
+    struct sigaction psa;
+    psa.sa_handler = handler;
+    sigemptyset(&psa.sa_mask);
+    psa.sa_flags = 0;
+    sigaction(SIGINT, &psa, NULL);
+
+    // 2. CONNEXION MÉMOIRE PARTAGÉE
+    // Pas de sem_open : les futex sont déjà dans le segment.
+    // La géométrie (nombre et taille des cases) est lue dans l'en-tête du segment.
+    Projection proj;
+    MemoirePartagee* shm = segment_attacher(options, &proj);
+    if (shm == NULL) exit(1);
+    partagee = shm;
+
+    // 3. MISE EN PLACE DU TUBE (FIFO) : secours, commandes en trames
+    Recepteur tube;
+    recepteur_ouvrir(&tube, FIFO_CONSO);
+
+    printf("--- Consommateur V4 (Anneau sans verrou + futex) Démarré : %lu cases de %lu octets ---\n",
+           (unsigned long) shm->capacite, (unsigned long) shm->taille_case);
+    projection_rapport(&proj, "Consommateur", options);
+
+    // On reprend là où en est le segment (comme en V3, on ne remet rien à 0).
+    // En diffusion, on part des messages publiés après notre inscription.
+    Cote conso;
+    cote_attacher(&conso, shm, 0);
+    if (shm->diffusion) {
+        if (curseur_inscrire(&conso, nom) == -1) {
+            fprintf(stderr, "Diffusion : déjà %d lecteurs inscrits.\n", LECTEURS_MAX);
+            segment_detacher(&proj);
+            exit(1);
+        }
+        printf("[Consommateur] Lecteur '%s' inscrit (diffusion) au message %lu.\n", nom, conso.position);
+    }
+
+    uint64_t prochain_tube = 0; // Heure de la prochaine lecture (de secours) du tube
+    uint64_t reprise = 0;       // Heure de la prochaine lecture (rythme de démonstration)
+
+    while (!stop) {
+        // A. COMMANDES (Prioritaires) : boîte aux lettres, puis tube une fois par seconde
+        char buffer_cmd[TAILLE_BOITE];
+        int cmd;
+        while ((cmd = commande_suivante(&conso, &tube, &prochain_tube, buffer_cmd, sizeof(buffer_cmd))) != CMD_AUCUNE) {
+            if (cmd == CMD_STOP) {
+                printf("\n[SYSTEM] Ordre d'arrêt reçu.\n");
+                stop = 1;
+                break;
+            } else {
+                printf("\n**************************************************\n");
+                printf("   MESSAGE EXTERNE REÇU : %s\n", buffer_cmd);
+                printf("**************************************************\n\n");
+            }
+        }
+        if (stop) break;
+
+        // Pause de démonstration, écourtée si une commande arrive -> retour en A.
+        if (cote_pause(&conso, &shm->parking_conso, reprise, &stop)) continue;
+        if (stop) break;
+
+        // B. CONSOMMATION NORMALE (sans copie intermédiaire)
+        // 1. On obtient la prochaine case pleine (attente seulement si VRAIMENT vide)
+        //    NULL : arrêt, ou commande arrivée pendant l'attente -> on reprend en A.
+        const char *item = lire_case(&conso, &stop);
+        if (item == NULL) continue;
+
+        // 2. Traitement SUR PLACE dans la mémoire partagée
+        printf("<- Conso : Lu '%s' (idx %lu)\n", item, conso.position & conso.masque);
+
+        // 3. La case est rendue au producteur
+        liberer_case(&conso, strlen(item) + 1);
+
+        reprise = horloge_ns() + PAUSE_DEMO_NS;
+    }
+
+    printf("\n[Consommateur] Fin.\n");
+
+    curseur_liberer(&conso);    // Le producteur ne doit plus nous attendre
+    partagee = NULL;
+    segment_detacher(&proj);
+
+    recepteur_fermer(&tube, FIFO_CONSO);
+
+    return 0;
+}
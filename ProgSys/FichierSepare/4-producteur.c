@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>   // Mémoire Partagée
+#include <sys/stat.h>   // Pour mkfifo
+#include <fcntl.h>      // Constantes O_*
+#include <signal.h>     // Gestion signaux
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>     // Lecture des options -H -P -L -D
+#include "4-common.h"
+
+// Variable globale modifiée par le handler de signal (interruption).
+volatile sig_atomic_t stop = 0;
+
+// Pointeur global pour que le handler puisse réveiller notre propre attente.
+MemoirePartagee* partagee = NULL;
+
+// Handler exécuté lors de la réception de SIGINT (Ctrl+C)
+void handler(int sig) {
+    stop = 1;
+    // Si on dort sur le futex "tampon plein", on se secoue pour voir 'stop'.
+    if (partagee != NULL) parking_secouer(&partagee->parking_prod, 0);
+}
+
+// Usage : ./4-producteur [-H] [-P] [-L] [-D] [capacite] [taille_case]
+//   capacite    : nombre de cases (arrondi à la puissance de 2 supérieure, 16 par défaut)
+//   taille_case : octets par message, '\0' compris (64 par défaut)
+//   -H : pages énormes   -P : pré-chargement (MAP_POPULATE)   -L : verrouillage (mlock)
+//   -D : diffusion : chaque consommateur lancé lit TOUS les messages (curseur
+//        par lecteur), le producteur attend le plus lent
+int main(int argc, char *argv[]) {
+    int options = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "HPLD")) != -1) {
+        if (opt == 'H') options |= MEM_HUGE;
+        else if (opt == 'P') options |= MEM_PREFAULT;
+        else if (opt == 'L') options |= MEM_VERROU;
+        else if (opt == 'D') options |= SEG_DIFFUSION;
+        else exit(1);
+    }
+    // Après getopt, argv[optind] est le premier argument positionnel.
+    unsigned long capacite = (optind < argc) ? strtoul(argv[optind], NULL, 10) : CAPACITE_DEFAUT;
+    unsigned long taille_case = (optind + 1 < argc) ? strtoul(argv[optind + 1], NULL, 10) : TAILLE_CASE_DEFAUT;
+    if (capacite < 1 || capacite > CAPACITE_MAX
+        || taille_case < TAILLE_CASE_MIN || taille_case > TAILLE_CASE_MAX) {
+        fprintf(stderr, "Usage : %s [-H] [-P] [-L] [-D] [capacite 1..%lu] [taille_case %d..%d]\n",
+                argv[0], CAPACITE_MAX, TAILLE_CASE_MIN, TAILLE_CASE_MAX);
+        exit(1);
+    }
+
+    // =================================================================
+    // 1. CONFIGURATION DES SIGNAUX
+    // =================================================================
+    struct sigaction psa;
+    psa.sa_handler = handler;
+    sigemptyset(&psa.sa_mask);
+    psa.sa_flags = 0;
+    sigaction(SIGINT, &psa, NULL);
+
+    // =================================================================
+    // 2. INITIALISATION MÉMOIRE PARTAGÉE (COTE CRÉATEUR)
+    // =================================================================
+    // Le segment est dimensionné (ftruncate) selon la géométrie demandée,
+    // qui est inscrite dans son en-tête pour les consommateurs.
+    Projection proj;
+    MemoirePartagee* shm = segment_creer(capacite, taille_case, options, &proj);
+    if (shm == NULL) exit(1);
+    partagee = shm;
+
+    // =================================================================
+    // 3. MISE EN PLACE DU TUBE NOMMÉ (FIFO) : secours, commandes en trames
+    // =================================================================
+    Recepteur tube;
+    if (recepteur_ouvrir(&tube, FIFO_PROD) == -1) {
+        perror("Avertissement : Erreur ouverture FIFO");
+    }
+
+    printf("--- Producteur V4 (Anneau sans verrou + futex) Démarré : %lu cases de %lu octets%s ---\n",
+           (unsigned long) shm->capacite, (unsigned long) shm->taille_case,
+           shm->diffusion ? ", diffusion" : "");
+    projection_rapport(&proj, "Producteur", options);
+
+    int k = 0;
+    char message_actuel[128];
+    snprintf(message_actuel, sizeof(message_actuel), "Defaut");
+
+    // Notre côté de l'anneau (séquences locales)
+    Cote prod;
+    cote_attacher(&prod, shm, 1);
+
+    uint64_t prochain_tube = 0; // Heure de la prochaine lecture (de secours) du tube
+    uint64_t reprise = 0;       // Heure du prochain message (rythme de démonstration)
+
+    // BOUCLE PRINCIPALE
+    while (!stop) {
+        // A. COMMANDES DU COMMUNICANT (toutes celles qui attendent)
+        // Boîte aux lettres du segment : un simple chargement mémoire par tour.
+        // Le tube n'est qu'un secours, lu au plus une fois par seconde.
+        char buffer_cmd[TAILLE_BOITE];
+        int cmd;
+        while ((cmd = commande_suivante(&prod, &tube, &prochain_tube, buffer_cmd, sizeof(buffer_cmd))) != CMD_AUCUNE) {
+            printf("\n[COMMANDE REÇUE] : '%s'\n", buffer_cmd);
+
+            if (cmd == CMD_STOP) {
+                printf("Ordre d'arrêt reçu.\n");
+                stop = 1;
+                break;
+            } else {
+                snprintf(message_actuel, sizeof(message_actuel), "%s", buffer_cmd);
+            }
+        }
+        if (stop) break;
+
+        // Pause de démonstration, écourtée si une commande arrive -> retour en A.
+        if (cote_pause(&prod, &shm->parking_prod, reprise, &stop)) continue;
+        if (stop) break;
+
+        // B. PRODUCTION NORMALE (sans copie intermédiaire)
+        // 1. On obtient la prochaine case libre (attente seulement si VRAIMENT plein)
+        //    NULL : arrêt, ou commande arrivée pendant l'attente -> on reprend en A.
+        char *item = reserver_case(&prod, &stop);
+        if (item == NULL) continue;
+
+        // 2. On formate DIRECTEMENT dans la mémoire partagée
+        snprintf(item, prod.taille_case, "%s-%d", message_actuel, k++);
+        printf("-> Prod : Ecrit '%s' (idx %lu)\n", item, prod.position & prod.masque);
+
+        // 3. Publication : la case devient visible pour le consommateur
+        valider_case(&prod, strlen(item) + 1);
+
+        reprise = horloge_ns() + PAUSE_DEMO_NS;
+    }
+
+    // =================================================================
+    // 4. NETTOYAGE COMPLET (Rôle du Créateur)
+    // =================================================================
+    printf("\n[Producteur] Fin. Nettoyage des ressources système.\n");
+
+    partagee = NULL;
+    segment_fermer(shm);     // Les communicants attachés voient que c'est fini
+    segment_detacher(&proj);
+    segment_supprimer();
+
+    recepteur_fermer(&tube, FIFO_PROD);
+
+    return 0;
+}
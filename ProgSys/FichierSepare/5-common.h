@@ -0,0 +1,64 @@
+#ifndef COMMON_H
+#define COMMON_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "../Outils/futex.h"   // Parking (futex) placé DANS le segment partagé
+#include "../Outils/controle.h" // Commandes du communicant en trames
+
+// --- PARAMÈTRES DE L'ANNEAU D'OCTETS ---
+// VERSION 5 : plus de cases fixes de 64 octets. Le tampon est une suite d'octets
+// dans laquelle chaque message occupe EXACTEMENT la place dont il a besoin.
+#define CAPACITE 4096   // Taille de l'anneau en octets
+#define ALIGNEMENT 8    // Chaque enregistrement commence sur un multiple de 8 octets
+#define TAILLE_LIGNE 64 // Taille d'une ligne de cache (octets)
+
+// --- IDENTIFIANTS DES RESSOURCES PARTAGÉES (VERSION 5) ---
+#define SHM_NAME "/mon_shm_v5"
+
+// --- IDENTIFIANTS DES TUBES NOMMÉS (FIFOs) ---
+// Mêmes tubes que la V3, et mêmes trames (Recepteur de controle.h) : le
+// communicant pilote les deux versions sans option particulière.
+#define FIFO_PROD "/tmp/fifo_prod_v3"
+#define FIFO_CONSO "/tmp/fifo_conso_v3"
+
+// --- EN-TÊTE D'UN ENREGISTREMENT ---
+// Chaque message est précédé de sa longueur ("length-prefixed").
+//   ENREG_DONNEE   : 'longueur' octets de texte suivent l'en-tête.
+//   ENREG_BOURRAGE : enregistrement vide qui remplit la fin de l'anneau quand
+//                    le message suivant n'y tient pas d'un seul morceau.
+//                    Le consommateur le saute et repart au début du tableau.
+// Grâce au bourrage, un message n'est JAMAIS coupé en deux par le bout de l'anneau.
+#define ENREG_DONNEE 1
+#define ENREG_BOURRAGE 2
+
+// Pour un texte, 'longueur' compte aussi le '\0' final (lisible directement avec printf).
+typedef struct {
+    uint32_t longueur; // Nombre d'octets utiles après l'en-tête
+    uint32_t type;     // ENREG_DONNEE ou ENREG_BOURRAGE
+} EnTeteEnreg;
+
+// Place totale occupée dans l'anneau par un enregistrement de 'longueur' octets utiles
+// (en-tête compris, arrondie au multiple de ALIGNEMENT supérieur).
+static inline size_t taille_enreg(size_t longueur) {
+    return (sizeof(EnTeteEnreg) + longueur + ALIGNEMENT - 1) & ~(size_t) (ALIGNEMENT - 1);
+}
+
+// Plus gros texte transportable (l'anneau entier moins l'en-tête et le '\0').
+#define LONGUEUR_MAX (CAPACITE - sizeof(EnTeteEnreg) - 1)
+
+// --- STRUCTURE DE LA MÉMOIRE PARTAGÉE (Layout V5) ---
+// Même synchronisation que la V4, mais 'tete' et 'queue' comptent des OCTETS :
+//   - Octets occupés = tete - queue
+//   - Position dans le tableau = sequence % CAPACITE
+typedef struct {
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long tete;  // Écrit par le Producteur
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long queue; // Écrit par le Consommateur
+    _Alignas(TAILLE_LIGNE) Parking parking_prod;        // Le producteur dort ici si pas assez de place
+    _Alignas(TAILLE_LIGNE) Parking parking_conso;       // Le consommateur dort ici si c'est vide
+    _Alignas(TAILLE_LIGNE) unsigned char octets[CAPACITE];
+} MemoirePartagee;
+
+#endif
@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <errno.h>
+#include "5-common.h"
+
+volatile sig_atomic_t stop = 0;
+MemoirePartagee* partagee = NULL;
+
+void handler(int sig) {
+    stop = 1;
+    if (partagee != NULL) parking_secouer(&partagee->parking_conso, 0);
+}
+
+int main() {
+    // 1. CONFIGURATION DU SIGNAL
+    struct sigaction psa;
+    psa.sa_handler = handler;
+    sigemptyset(&psa.sa_mask);
+    psa.sa_flags = 0;
+    sigaction(SIGINT, &psa, NULL);
+
+    // 2. CONNEXION MÉMOIRE PARTAGÉE
+    int fd_shm = shm_open(SHM_NAME, O_RDWR, 0666);
+    if (fd_shm == -1) {
+        perror("Lancez le producteur avant");
+        exit(1);
+    }
+    MemoirePartagee* shm = mmap(NULL, sizeof(MemoirePartagee), PROT_READ | PROT_WRITE, MAP_SHARED, fd_shm, 0);
+    close(fd_shm);
+    if (shm == MAP_FAILED) {
+        perror("Erreur mmap");
+        exit(1);
+    }
+    partagee = shm;
+
+    // 3. MISE EN PLACE DU TUBE (FIFO)
+    Recepteur tube;
+    recepteur_ouvrir(&tube, FIFO_CONSO);
+
+    printf("--- Consommateur V5 (Anneau d'octets) Démarré ---\n");
+
+    unsigned long tete_connue = atomic_load_explicit(&shm->tete, memory_order_acquire);
+
+    while (!stop) {
+        // A. LECTURE DU TUBE (Prioritaire)
+        char buffer_cmd[CONTROLE_MAX];
+        while (recepteur_lire(&tube, buffer_cmd, sizeof(buffer_cmd))) {
+            if (strcmp(buffer_cmd, "stop") == 0) {
+                printf("\n[SYSTEM] Ordre d'arrêt reçu via le tube.\n");
+                stop = 1;
+                break;
+            } else {
+                printf("\n**************************************************\n");
+                printf("   MESSAGE EXTERNE REÇU : %s\n", buffer_cmd);
+                printf("**************************************************\n\n");
+            }
+        }
+        if (stop) break;
+
+        // B. CONSOMMATION NORMALE
+        unsigned long q = atomic_load_explicit(&shm->queue, memory_order_relaxed);
+
+        // Attente d'un enregistrement : UNIQUEMENT si l'anneau est vraiment vide.
+        while (!stop && q == tete_connue) {
+            tete_connue = atomic_load_explicit(&shm->tete, memory_order_acquire);
+            if (q == tete_connue) {
+                parking_attendre(&shm->parking_conso, &shm->tete, tete_connue, &stop, 0);
+            }
+        }
+        if (stop) break;
+
+        // Lecture de l'en-tête à la position courante
+        EnTeteEnreg *entete = (EnTeteEnreg *) &shm->octets[q % CAPACITE];
+        size_t taille = taille_enreg(entete->longueur);
+
+        if (entete->type == ENREG_BOURRAGE) {
+            // Bout de l'anneau : on saute le bourrage et on repart au début, sans pause.
+            atomic_store_explicit(&shm->queue, q + taille, memory_order_release);
+            parking_reveiller(&shm->parking_prod, 0);
+            continue;
+        }
+
+        // Le texte est lu SUR PLACE dans l'anneau ('longueur' compte son '\0' final).
+        printf("<- Conso : Lu '%s' (%u octets, pos %lu)\n", (char *) (entete + 1),
+               entete->longueur - 1, q % CAPACITE);
+
+        // Libération des octets (release) puis réveil du producteur S'IL dort.
+        atomic_store_explicit(&shm->queue, q + taille, memory_order_release);
+        parking_reveiller(&shm->parking_prod, 0);
+
+        sleep(1);
+    }
+
+    printf("\n[Consommateur] Fin.\n");
+
+    partagee = NULL;
+    munmap(shm, sizeof(MemoirePartagee));
+
+    recepteur_fermer(&tube, FIFO_CONSO);
+
+    return 0;
+}
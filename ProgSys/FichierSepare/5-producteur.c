@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>   // Mémoire Partagée
+#include <sys/stat.h>   // Pour mkfifo
+#include <fcntl.h>      // Constantes O_*
+#include <signal.h>     // Gestion signaux
+#include <string.h>
+#include <errno.h>
+#include "5-common.h"
+
+volatile sig_atomic_t stop = 0;
+MemoirePartagee* partagee = NULL;
+
+void handler(int sig) {
+    stop = 1;
+    if (partagee != NULL) parking_secouer(&partagee->parking_prod, 0);
+}
+
+// Copie locale de 'queue' (on ne relit la ligne de cache du consommateur
+// que lorsque la place nous SEMBLE insuffisante).
+unsigned long queue_connue = 0;
+
+// Attend qu'au moins 'besoin' octets soient libres. Renvoie 0, ou -1 si 'stop'.
+int attendre_place(MemoirePartagee *shm, unsigned long t, size_t besoin) {
+    while (!stop && CAPACITE - (t - queue_connue) < besoin) {
+        queue_connue = atomic_load_explicit(&shm->queue, memory_order_acquire);
+        if (CAPACITE - (t - queue_connue) < besoin) {
+            parking_attendre(&shm->parking_prod, &shm->queue, queue_connue, &stop, 0);
+        }
+    }
+    return stop ? -1 : 0;
+}
+
+// Réserve 'taille' octets CONTIGUS dans l'anneau et renvoie leur adresse.
+// Si la fin du tableau est trop courte, on y pose d'abord un enregistrement de
+// bourrage, publié tout seul : il sera consommé et la place au début se libèrera.
+// Renvoie NULL si 'stop'.
+unsigned char *reserver(MemoirePartagee *shm, size_t taille) {
+    unsigned long t = atomic_load_explicit(&shm->tete, memory_order_relaxed);
+    size_t pos = t % CAPACITE;
+    size_t jusqu_au_bout = CAPACITE - pos;
+
+    if (taille > jusqu_au_bout) {
+        // 1. Bourrage jusqu'au bout du tableau (toujours >= 8 octets grâce à l'alignement)
+        if (attendre_place(shm, t, jusqu_au_bout) == -1) return NULL;
+        EnTeteEnreg *bourrage = (EnTeteEnreg *) &shm->octets[pos];
+        bourrage->longueur = jusqu_au_bout - sizeof(EnTeteEnreg);
+        bourrage->type = ENREG_BOURRAGE;
+        t += jusqu_au_bout;
+        atomic_store_explicit(&shm->tete, t, memory_order_release);
+        parking_reveiller(&shm->parking_conso, 0);
+        pos = 0;
+    }
+
+    // 2. Le message tient d'un seul morceau à partir de 'pos'
+    if (attendre_place(shm, t, taille) == -1) return NULL;
+    return &shm->octets[pos];
+}
+
+// Rend visibles les 'taille' octets réservés (release) et réveille le consommateur S'IL dort.
+void publier(MemoirePartagee *shm, size_t taille) {
+    unsigned long t = atomic_load_explicit(&shm->tete, memory_order_relaxed);
+    atomic_store_explicit(&shm->tete, t + taille, memory_order_release);
+    parking_reveiller(&shm->parking_conso, 0);
+}
+
+int main() {
+    // =================================================================
+    // 1. CONFIGURATION DES SIGNAUX
+    // =================================================================
+    struct sigaction psa;
+    psa.sa_handler = handler;
+    sigemptyset(&psa.sa_mask);
+    psa.sa_flags = 0;
+    sigaction(SIGINT, &psa, NULL);
+
+    // =================================================================
+    // 2. INITIALISATION MÉMOIRE PARTAGÉE (COTE CRÉATEUR)
+    // =================================================================
+    int fd_shm = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
+    if (fd_shm == -1) {
+        perror("Erreur shm_open");
+        exit(1);
+    }
+    ftruncate(fd_shm, sizeof(MemoirePartagee));
+
+    MemoirePartagee* shm = mmap(NULL, sizeof(MemoirePartagee),
+                                PROT_READ | PROT_WRITE, MAP_SHARED, fd_shm, 0);
+    close(fd_shm);
+    if (shm == MAP_FAILED) {
+        perror("Erreur mmap");
+        exit(1);
+    }
+    memset(shm, 0, sizeof(MemoirePartagee));
+    partagee = shm;
+
+    // =================================================================
+    // 3. MISE EN PLACE DU TUBE NOMMÉ (FIFO)
+    // =================================================================
+    Recepteur tube;
+    if (recepteur_ouvrir(&tube, FIFO_PROD) == -1) {
+        perror("Avertissement : Erreur ouverture FIFO");
+    }
+
+    printf("--- Producteur V5 (Anneau d'octets, %d octets) Démarré ---\n", CAPACITE);
+
+    int k = 0;
+    // Plus de limite à 64 octets : seules la taille d'une commande et celle de l'anneau comptent.
+    char message_actuel[CONTROLE_MAX];
+    snprintf(message_actuel, sizeof(message_actuel), "Defaut");
+
+    while (!stop) {
+        // A. LECTURE NON-BLOQUANTE DU TUBE (toutes les trames arrivées)
+        char buffer_cmd[CONTROLE_MAX];
+        while (recepteur_lire(&tube, buffer_cmd, sizeof(buffer_cmd))) {
+            printf("\n[COMMANDE REÇUE] : '%s'\n", buffer_cmd);
+
+            if (strcmp(buffer_cmd, "stop") == 0) {
+                printf("Ordre d'arrêt reçu via le tube.\n");
+                stop = 1;
+                break;
+            } else {
+                snprintf(message_actuel, sizeof(message_actuel), "%s", buffer_cmd);
+            }
+        }
+        if (stop) break;
+
+        // B. PRODUCTION NORMALE
+        // 1. Longueur exacte du message (snprintf avec taille 0 ne fait que compter)
+        int longueur = snprintf(NULL, 0, "%s-%d", message_actuel, k);
+        if (longueur < 0 || (size_t) longueur >= LONGUEUR_MAX) {
+            fprintf(stderr, "Message trop long pour l'anneau (%d octets), ignoré.\n", longueur);
+            k++;
+            sleep(1);
+            continue;
+        }
+
+        // 2. Réservation de la place exacte (le '\0' final est compté dans l'enregistrement)
+        size_t taille = taille_enreg(longueur + 1);
+        unsigned char *enreg = reserver(shm, taille);
+        if (enreg == NULL) break;
+
+        // 3. Écriture DIRECTE dans l'anneau : en-tête puis texte
+        EnTeteEnreg *entete = (EnTeteEnreg *) enreg;
+        entete->longueur = longueur + 1;
+        entete->type = ENREG_DONNEE;
+        snprintf((char *) (entete + 1), longueur + 1, "%s-%d", message_actuel, k++);
+
+        printf("-> Prod : Ecrit '%s' (%d octets, pos %lu)\n", (char *) (entete + 1), longueur,
+               (unsigned long) (enreg - shm->octets));
+
+        // 4. Publication
+        publier(shm, taille);
+
+        sleep(1);
+    }
+
+    // =================================================================
+    // 4. NETTOYAGE COMPLET (Rôle du Créateur)
+    // =================================================================
+    printf("\n[Producteur] Fin. Nettoyage des ressources système.\n");
+
+    partagee = NULL;
+    munmap(shm, sizeof(MemoirePartagee));
+    shm_unlink(SHM_NAME);
+
+    recepteur_fermer(&tube, FIFO_PROD);
+
+    return 0;
+}
@@ -0,0 +1,282 @@
+#ifndef COMMON_H
+#define COMMON_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <dirent.h>     // Liste des fichiers segments (scandir)
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdatomic.h>
+#include "../Outils/futex.h"   // Parking (futex) placé dans le fichier d'état partagé
+#include "../Outils/histo.h"   // horloge_ns (lecture espacée des tubes, synchronisations)
+#include "../Outils/controle.h" // Trames de commande sur les tubes
+
+// =================================================================
+// VERSION 6 : REGISTRE DURABLE (fichiers segments ajoutés en fin)
+// =================================================================
+// Jusqu'à la V5, l'anneau ne vit que dans /dev/shm : le producteur fait
+// shm_unlink en partant et tout ce qui n'a pas été lu est perdu.
+//
+// Ici, les messages sont AJOUTÉS à la suite dans des fichiers ordinaires
+// (projetés avec mmap), jamais réécrits :
+//   <dossier>/00000000000000000000.seg  messages 0, 1, 2...
+//   <dossier>/00000000000000001234.seg  le fichier suivant commence au message 1234
+//   <dossier>/<même nom>.idx            index CLAIRSEMÉ du segment
+//   <dossier>/etat                      petit fichier partagé (tête, parking)
+//   <dossier>/conso-<nom>.pos           position VALIDÉE d'un consommateur
+//
+// Durabilité par LOTS : le producteur ne force l'écriture sur disque (msync +
+// fdatasync) qu'une fois par intervalle (-s), jamais à chaque message. Une
+// panne fait perdre au plus le dernier intervalle.
+//
+// Recherche en O(log n) : dichotomie sur les noms des segments (numéro du
+// premier message), puis dans l'index du segment (une entrée tous les
+// PAS_INDEX octets), puis au plus PAS_INDEX octets lus à la suite.
+
+#define DOSSIER_DEFAUT "/tmp/registre_v6"
+#define FICHIER_ETAT "etat"
+#define TAILLE_SEGMENT_DEFAUT (4UL << 20)   // 4 Mio par fichier segment
+#define TAILLE_SEGMENT_MIN (64UL << 10)
+#define TAILLE_SEGMENT_MAX (1UL << 30)
+#define PAS_INDEX 4096          // Une entrée d'index tous les 4 Kio de messages
+#define SYNC_DEFAUT_MS 200      // Intervalle entre deux synchronisations disque
+#define GARDER_DEFAUT 8         // Segments conservés (les plus anciens sont supprimés)
+#define TAILLE_MSG_MAX 1024     // Texte le plus long ('\0' compris)
+#define ALIGNEMENT 8
+#define PAUSE_DEMO_MS 1000      // Rythme de démonstration : un message par seconde
+#define PERIODE_TUBE_NS 100000000ULL    // Lecture des tubes au plus toutes les 100 ms
+
+// "Signature" du fichier d'état ("REG6" en mémoire)
+#define MAGIQUE_V6 0x36474552u
+#define VERSION_LAYOUT 1
+
+// Mêmes tubes que la V3, commandes en TRAMES (comme la V4).
+#define FIFO_PROD "/tmp/fifo_prod_v3"
+#define FIFO_CONSO "/tmp/fifo_conso_v3"
+
+// --- EN-TÊTE D'UN MESSAGE DANS UN SEGMENT ---
+// 'longueur' est écrite EN DERNIER (release) : tant qu'elle vaut 0, le message
+// n'existe pas encore. FIN_SEGMENT : la suite est dans le fichier suivant.
+// 'controle' (somme du texte) détecte un message à moitié écrit lors d'une panne.
+#define FIN_SEGMENT 0xFFFFFFFFu
+
+typedef struct {
+    _Atomic uint32_t longueur;  // Octets de texte, '\0' compris
+    uint32_t controle;          // Somme de contrôle FNV-1a du texte
+    uint64_t sequence;          // Numéro du message (continu d'un segment à l'autre)
+    uint64_t horodatage;        // CLOCK_REALTIME en ns : garde son sens après un redémarrage
+} EnTeteMsg;
+
+// Place totale occupée par un message de 'longueur' octets (en-tête compris, aligné).
+static inline size_t taille_msg(size_t longueur) {
+    return (sizeof(EnTeteMsg) + longueur + ALIGNEMENT - 1) & ~(size_t) (ALIGNEMENT - 1);
+}
+
+static inline uint32_t somme_controle(const void *donnees, size_t n) {
+    const unsigned char *p = donnees;
+    uint32_t h = 2166136261u;
+    for (size_t k = 0; k < n; k++) h = (h ^ p[k]) * 16777619u;
+    return h;
+}
+
+static inline uint64_t horloge_reelle_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// --- INDEX CLAIRSEMÉ D'UN SEGMENT ---
+// Trié par construction (les messages sont ajoutés dans l'ordre) : on y cherche
+// par dichotomie une séquence OU une heure.
+typedef struct {
+    uint64_t sequence;
+    uint64_t horodatage;
+    uint64_t position;          // Décalage du message dans le fichier segment
+} EntreeIndex;
+
+typedef struct {
+    _Atomic uint64_t nombre;    // Entrées valides (publiées après l'entrée elle-même)
+    uint64_t reserve;
+    EntreeIndex e[];
+} Index;
+
+static inline size_t taille_index(size_t taille_segment) {
+    return sizeof(Index) + (taille_segment / PAS_INDEX + 2) * sizeof(EntreeIndex);
+}
+
+// --- FICHIER D'ÉTAT (partagé par tous, projeté par chacun) ---
+typedef struct {
+    _Atomic uint32_t magique;
+    uint32_t version;
+    uint64_t taille_segment;
+    _Alignas(64) _Atomic uint64_t tete;     // Prochain numéro : tout ce qui est avant est lisible
+    _Atomic uint64_t premier;               // Plus ancien message encore conservé
+    _Atomic uint64_t durable;               // Tout ce qui est avant est sur disque (borne des validations)
+    _Atomic uint64_t reprise;               // Premier message de la vie en cours du producteur
+    _Alignas(64) Parking parking_conso;     // Les consommateurs à jour dorment ici
+} Etat;
+
+// Réveille TOUS les consommateurs endormis (il peut y en avoir plusieurs),
+// sans appel système si personne ne dort.
+static inline void etat_reveiller(Etat *e) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&e->parking_conso.endormi, memory_order_relaxed) > 0)
+        parking_secouer(&e->parking_conso, 0);
+}
+
+// Projette le fichier d'état ('creer' : le producteur le crée s'il n'existe pas).
+// Renvoie NULL si le fichier n'existe pas (encore) ou en cas d'erreur.
+static inline Etat *etat_ouvrir(const char *dossier, int creer) {
+    char chemin[4096];
+    snprintf(chemin, sizeof(chemin), "%s/%s", dossier, FICHIER_ETAT);
+    int fd = open(chemin, creer ? O_RDWR | O_CREAT : O_RDWR, 0666);
+    if (fd == -1) return NULL;
+    if (creer && ftruncate(fd, sizeof(Etat)) == -1) {
+        close(fd);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t) st.st_size < sizeof(Etat)) {
+        close(fd);
+        return NULL;
+    }
+    Etat *e = mmap(NULL, sizeof(Etat), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return e == MAP_FAILED ? NULL : e;
+}
+
+// --- UN SEGMENT (vue locale d'un fichier .seg et de son .idx) ---
+typedef struct {
+    uint64_t base;              // Numéro du premier message du fichier
+    size_t taille;
+    unsigned char *octets;      // Projection du fichier segment
+    Index *index;               // Projection de son index
+} Segment;
+
+static inline void chemin_segment(char *dst, size_t n, const char *dossier, uint64_t base, const char *ext) {
+    snprintf(dst, n, "%s/%020llu.%s", dossier, (unsigned long long) base, ext);
+}
+
+static inline void segment_fermer(Segment *s) {
+    if (s->octets != NULL) munmap(s->octets, s->taille);
+    if (s->index != NULL) munmap(s->index, taille_index(s->taille));
+    s->octets = NULL;
+    s->index = NULL;
+}
+
+static inline void *projeter_fichier(const char *chemin, size_t taille, int ecrire) {
+    int fd = open(chemin, ecrire ? O_RDWR | O_CREAT : O_RDONLY, 0666);
+    if (fd == -1) return NULL;
+    // Fichier creux : ftruncate ne réserve rien, les blocs sont alloués au fil de l'eau.
+    if (ecrire && ftruncate(fd, taille) == -1) {
+        close(fd);
+        return NULL;
+    }
+    void *p = mmap(NULL, taille, ecrire ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+// Ouvre (ou crée, pour le producteur) le segment qui commence au message 'base'.
+// 'taille' : taille des fichiers segments (lue dans l'état par les consommateurs).
+static inline int segment_ouvrir(Segment *s, const char *dossier, uint64_t base, size_t taille, int ecrire) {
+    char chemin[4096];
+    s->base = base;
+    s->taille = taille;
+    chemin_segment(chemin, sizeof(chemin), dossier, base, "seg");
+    s->octets = projeter_fichier(chemin, taille, ecrire);
+    chemin_segment(chemin, sizeof(chemin), dossier, base, "idx");
+    s->index = projeter_fichier(chemin, taille_index(taille), ecrire);
+    if (s->octets == NULL || s->index == NULL) {
+        segment_fermer(s);
+        return -1;
+    }
+    return 0;
+}
+
+static inline EnTeteMsg *message_a(const Segment *s, size_t position) {
+    return (EnTeteMsg *) (s->octets + position);
+}
+
+// Le message à 'position' est-il publié, de longueur plausible, entier dans
+// le segment, et bien le numéro 'sequence' ? Renvoie sa longueur, 0 sinon
+// (une marque FIN_SEGMENT aussi renvoie 0). Producteur (reprise) et
+// consommateurs (lecture) font les mêmes vérifications : rien n'est lu hors
+// du fichier, même si l'en-tête est à moitié écrit ou laissé par une autre vie.
+static inline uint32_t message_lisible(const Segment *s, size_t position, uint64_t sequence) {
+    if (position + sizeof(EnTeteMsg) > s->taille) return 0;
+    EnTeteMsg *h = message_a(s, position);
+    uint32_t longueur = atomic_load_explicit(&h->longueur, memory_order_acquire);
+    if (longueur == 0 || longueur > TAILLE_MSG_MAX || position + taille_msg(longueur) > s->taille
+        || h->sequence != sequence) return 0;
+    return longueur;
+}
+
+// Comme message_lisible, et en plus complet (somme de contrôle juste).
+static inline int message_valide(const Segment *s, size_t position, uint64_t sequence) {
+    uint32_t longueur = message_lisible(s, position, sequence);
+    EnTeteMsg *h = message_a(s, position);
+    return longueur != 0 && h->controle == somme_controle(h + 1, longueur);
+}
+
+// --- LISTE DES SEGMENTS ---
+static int filtre_segment(const struct dirent *d) {
+    size_t n = strlen(d->d_name);
+    return n == 24 && strcmp(d->d_name + 20, ".seg") == 0;
+}
+
+// Numéros de base de tous les segments, triés (les noms sont de largeur fixe,
+// l'ordre alphabétique est donc l'ordre numérique). Renvoie leur nombre (-1 si erreur).
+static inline int segments_lister(const char *dossier, uint64_t **bases) {
+    struct dirent **noms;
+    *bases = NULL;
+    int n = scandir(dossier, &noms, filtre_segment, alphasort);
+    if (n < 0) return -1;
+    *bases = malloc((n > 0 ? n : 1) * sizeof(uint64_t));
+    for (int k = 0; k < n; k++) {
+        (*bases)[k] = strtoull(noms[k]->d_name, NULL, 10);
+        free(noms[k]);
+    }
+    free(noms);
+    return n;
+}
+
+// Dichotomie : indice du dernier segment dont la base est <= 'sequence' (0 si aucun).
+static inline int segment_chercher(const uint64_t *bases, int n, uint64_t sequence) {
+    int bas = 0, haut = n - 1;
+    while (bas < haut) {
+        int milieu = (bas + haut + 1) / 2;
+        if (bases[milieu] <= sequence) bas = milieu;
+        else haut = milieu - 1;
+    }
+    return bas;
+}
+
+// Dichotomie dans l'index : position de départ d'un parcours qui trouvera le
+// premier message de numéro >= 'sequence' (par_heure = 0) ou d'heure >= 'heure'
+// (par_heure = 1). Au pire PAS_INDEX octets à lire ensuite.
+// '*sequence' reçoit le numéro du message à cette position (inchangé si 0 est renvoyé).
+static inline size_t index_chercher(const Index *ix, uint64_t cle, int par_heure, uint64_t *sequence) {
+    uint64_t n = atomic_load_explicit(&ix->nombre, memory_order_acquire);
+    if (n == 0) return 0;
+    uint64_t bas = 0, haut = n - 1;
+    while (bas < haut) {
+        uint64_t milieu = (bas + haut + 1) / 2;
+        uint64_t v = par_heure ? ix->e[milieu].horodatage : ix->e[milieu].sequence;
+        if (v < cle || (!par_heure && v == cle)) bas = milieu;
+        else haut = milieu - 1;
+    }
+    uint64_t v = par_heure ? ix->e[bas].horodatage : ix->e[bas].sequence;
+    if (!(v < cle || (!par_heure && v == cle))) return 0;
+    *sequence = ix->e[bas].sequence;
+    return ix->e[bas].position;
+}
+
+#endif
@@ -0,0 +1,322 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>     // Lecture des options -d -n -r -h -c -q
+#include "6-common.h"
+
+volatile sig_atomic_t stop = 0;
+Etat *partage = NULL;   // Pour que le handler puisse réveiller notre propre attente
+
+void handler(int sig) {
+    stop = 1;
+    if (partage != NULL) parking_secouer(&partage->parking_conso, 0);
+}
+
+// --- CÔTÉ LECTEUR DU REGISTRE ---
+typedef struct {
+    const char *dossier;
+    Etat *etat;
+    Segment seg;                // Segment en cours de lecture (projeté en lecture seule)
+    size_t position;            // Prochain message à lire dans le segment
+    uint64_t suivant;           // Numéro du prochain message attendu
+} Lecteur;
+
+// Position VALIDÉE : seule trace d'un consommateur entre deux lancements.
+typedef struct {
+    uint64_t sequence;          // Premier message PAS encore traité
+    uint64_t horodatage;        // Heure de la validation (information)
+} Validation;
+
+// Heure du premier message d'un segment (lu avec pread, sans projeter le fichier).
+// Renvoie 0 si le segment est vide ou illisible.
+static uint64_t premiere_heure(const char *dossier, uint64_t base) {
+    char chemin[4096];
+    chemin_segment(chemin, sizeof(chemin), dossier, base, "seg");
+    int fd = open(chemin, O_RDONLY);
+    if (fd == -1) return 0;
+    struct { uint32_t longueur, controle; uint64_t sequence, horodatage; } h;
+    ssize_t n = pread(fd, &h, sizeof(h), 0);
+    close(fd);
+    return (n == (ssize_t) sizeof(h) && h.longueur != 0 && h.longueur != FIN_SEGMENT) ? h.horodatage : 0;
+}
+
+// Marque FIN_SEGMENT à la position courante ?
+static int lecteur_fin_segment(const Lecteur *l) {
+    return l->position + sizeof(EnTeteMsg) <= l->seg.taille
+        && atomic_load_explicit(&message_a(&l->seg, l->position)->longueur, memory_order_acquire) == FIN_SEGMENT;
+}
+
+// Avance jusqu'au premier message de numéro >= 'cle' (ou d'heure >= 'cle'),
+// en passant d'un segment au suivant si besoin. S'arrête aussi sur la fin des
+// données publiées ('tete'), ou sur un message qui n'est pas celui attendu
+// (message_lisible) : l'appelant s'en aperçoit en lisant.
+static void lecteur_parcourir(Lecteur *l, uint64_t cle, int par_heure) {
+    while (!stop) {
+        EnTeteMsg *h = message_a(&l->seg, l->position);
+        if (lecteur_fin_segment(l)) {
+            uint64_t base = h->sequence;
+            segment_fermer(&l->seg);
+            if (segment_ouvrir(&l->seg, l->dossier, base, l->etat->taille_segment, 0) == -1) return;
+            l->position = 0;
+            l->suivant = base;
+            continue;
+        }
+        if (l->suivant >= atomic_load_explicit(&l->etat->tete, memory_order_acquire)) return;
+        uint32_t longueur = message_lisible(&l->seg, l->position, l->suivant);
+        if (longueur == 0 || (par_heure ? h->horodatage : h->sequence) >= cle) return;
+        l->position += taille_msg(longueur);
+        l->suivant++;
+    }
+}
+
+// Se place sur le message 'cle' (numéro, ou heure si par_heure) en O(log n) :
+//   1. dichotomie sur les segments (par leur nom, ou par l'heure de leur premier message),
+//   2. dichotomie dans l'index clairsemé du segment trouvé,
+//   3. lecture à la suite d'au plus PAS_INDEX octets.
+// Un numéro plus ancien que le premier message conservé mène au premier conservé.
+// Renvoie 0, ou -1 si le registre est encore vide.
+static int lecteur_placer(Lecteur *l, uint64_t cle, int par_heure) {
+    uint64_t *bases;
+    int n = segments_lister(l->dossier, &bases);
+    if (n <= 0) {
+        free(bases);
+        return -1;
+    }
+    int k;
+    if (par_heure) {
+        int bas = 0, haut = n - 1;
+        while (bas < haut) {
+            int milieu = (bas + haut + 1) / 2;
+            uint64_t t = premiere_heure(l->dossier, bases[milieu]);
+            if (t != 0 && t < cle) bas = milieu;
+            else haut = milieu - 1;
+        }
+        k = bas;
+    } else {
+        k = segment_chercher(bases, n, cle);
+    }
+    uint64_t base = bases[k];
+    free(bases);
+
+    segment_fermer(&l->seg);
+    if (segment_ouvrir(&l->seg, l->dossier, base, l->etat->taille_segment, 0) == -1) return -1;
+    l->suivant = base;
+    l->position = index_chercher(l->seg.index, cle, par_heure, &l->suivant);
+    lecteur_parcourir(l, cle, par_heure);
+    return 0;
+}
+
+// Écrit la position validée et attend le disque : UNE fois par intervalle
+// (-c), jamais à chaque message. Après une panne, le consommateur relit au
+// plus ce qu'il avait traité depuis la dernière validation.
+// Jamais au-delà de 'durable' : après une panne du PRODUCTEUR, les messages
+// pas encore sur disque sont perdus et leurs numéros redonnés à d'autres ;
+// une position validée plus loin sauterait ces nouveaux messages.
+// Renvoie la position effectivement validée.
+static uint64_t valider(int fd, uint64_t sequence, Etat *etat) {
+    uint64_t durable = atomic_load_explicit(&etat->durable, memory_order_acquire);
+    if (sequence > durable) sequence = durable;
+    Validation v = { sequence, horloge_reelle_ns() };
+    if (pwrite(fd, &v, sizeof(v), 0) == (ssize_t) sizeof(v)) fdatasync(fd);
+    return sequence;
+}
+
+// Usage : ./6-consommateur [-d dossier] [-n nom] [-r sequence | -h secondes] [-c validation_ms] [-q]
+//   -d : dossier du registre (/tmp/registre_v6 par défaut)
+//   -n : nom du consommateur ("conso" par défaut) : chacun a sa position validée
+//   -r : reprend au message 'sequence' au lieu de la position validée
+//   -h : reprend aux messages des 'secondes' dernières secondes
+//   -c : intervalle entre deux validations de la position (1000 ms par défaut)
+//   -q : n'affiche pas chaque message (seulement le bilan)
+int main(int argc, char *argv[]) {
+    const char *dossier = DOSSIER_DEFAUT;
+    const char *nom = "conso";
+    long long sequence_demandee = -1;
+    double secondes_demandees = -1;
+    int validation_ms = 1000;
+    int silencieux = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "d:n:r:h:c:q")) != -1) {
+        if (opt == 'd') dossier = optarg;
+        else if (opt == 'n') nom = optarg;
+        else if (opt == 'r') sequence_demandee = atoll(optarg);
+        else if (opt == 'h') secondes_demandees = atof(optarg);
+        else if (opt == 'c') validation_ms = atoi(optarg);
+        else if (opt == 'q') silencieux = 1;
+        else exit(1);
+    }
+    if (validation_ms <= 0) validation_ms = 1000;
+
+    struct sigaction psa;
+    psa.sa_handler = handler;
+    sigemptyset(&psa.sa_mask);
+    psa.sa_flags = 0;
+    sigaction(SIGINT, &psa, NULL);
+
+    // 1. CONNEXION AU REGISTRE (attente du premier lancement du producteur)
+    Etat *etat = NULL;
+    while (!stop) {
+        etat = etat_ouvrir(dossier, 0);
+        if (etat != NULL && atomic_load_explicit(&etat->magique, memory_order_acquire) == MAGIQUE_V6) break;
+        if (etat != NULL) munmap(etat, sizeof(Etat));
+        etat = NULL;
+        printf("[Consommateur] En attente d'un registre V6 dans %s...\n", dossier);
+        sleep(1);
+    }
+    if (etat == NULL) exit(0);
+    partage = etat;
+
+    // 2. POSITION VALIDÉE (ou demandée)
+    char chemin[4096];
+    snprintf(chemin, sizeof(chemin), "%s/conso-%s.pos", dossier, nom);
+    int fd_pos = open(chemin, O_RDWR | O_CREAT, 0666);
+    if (fd_pos == -1) {
+        perror("Erreur ouverture de la position validée");
+        exit(1);
+    }
+    Validation v = { 0, 0 };
+    int valide = (pread(fd_pos, &v, sizeof(v), 0) == (ssize_t) sizeof(v));
+
+    Lecteur l;
+    memset(&l, 0, sizeof(l));
+    l.dossier = dossier;
+    l.etat = etat;
+    uint64_t cle = valide ? v.sequence : atomic_load(&etat->premier);
+    int par_heure = 0;
+    if (sequence_demandee >= 0) cle = (uint64_t) sequence_demandee;
+    if (secondes_demandees >= 0) {
+        cle = horloge_reelle_ns() - (uint64_t) (secondes_demandees * 1e9);
+        par_heure = 1;
+    }
+
+    uint64_t t0 = horloge_ns();
+    while (lecteur_placer(&l, cle, par_heure) == -1 && !stop) sleep(1);
+    if (stop) exit(0);
+    printf("--- Consommateur V6 (Registre durable) '%s' Démarré : reprise au message %llu "
+           "(segment %llu, octet %zu, trouvé en %.1f µs) ---\n", nom,
+           (unsigned long long) l.suivant, (unsigned long long) l.seg.base, l.position,
+           (horloge_ns() - t0) / 1e3);
+    if (!par_heure && l.suivant > cle) {
+        printf("[Consommateur] Messages %llu à %llu déjà supprimés (rétention).\n",
+               (unsigned long long) cle, (unsigned long long) l.suivant - 1);
+    }
+
+    // 3. TUBE DE COMMANDES
+    Recepteur tube;
+    if (recepteur_ouvrir(&tube, FIFO_CONSO) == -1) {
+        perror("Avertissement : Erreur ouverture FIFO");
+    }
+
+    uint64_t debut = horloge_ns();
+    uint64_t prochain_tube = 0;
+    uint64_t prochaine_validation = debut + (uint64_t) validation_ms * 1000000ULL;
+    uint64_t valide_jusqua = l.suivant;
+    uint64_t reprise_vue = atomic_load(&etat->reprise);
+    unsigned long long lus = 0;
+
+    while (!stop) {
+        uint64_t maintenant = horloge_ns();
+
+        // A. COMMANDES (au plus une lecture du tube par PERIODE_TUBE_NS)
+        if (maintenant >= prochain_tube) {
+            prochain_tube = maintenant + PERIODE_TUBE_NS;
+            char buffer_cmd[CONTROLE_MAX];
+            while (recepteur_lire(&tube, buffer_cmd, sizeof(buffer_cmd))) {
+                if (strcmp(buffer_cmd, "stop") == 0) {
+                    printf("\n[SYSTEM] Ordre d'arrêt reçu.\n");
+                    stop = 1;
+                    break;
+                }
+                printf("\n**************************************************\n");
+                printf("   MESSAGE EXTERNE REÇU : %s\n", buffer_cmd);
+                printf("**************************************************\n\n");
+            }
+            if (stop) break;
+        }
+
+        // B. VALIDATION PAR LOTS
+        if (maintenant >= prochaine_validation) {
+            if (l.suivant != valide_jusqua) valide_jusqua = valider(fd_pos, l.suivant, etat);
+            prochaine_validation = maintenant + (uint64_t) validation_ms * 1000000ULL;
+        }
+
+        // C. LECTURE
+        EnTeteMsg *h = message_a(&l.seg, l.position);
+        if (lecteur_fin_segment(&l)) {
+            // Segment suivant. S'il a déjà été supprimé (consommateur trop en
+            // retard), on repart du plus ancien message conservé.
+            uint64_t base = h->sequence;
+            segment_fermer(&l.seg);
+            if (segment_ouvrir(&l.seg, dossier, base, etat->taille_segment, 0) == 0) {
+                l.position = 0;
+            } else {
+                uint64_t premier = atomic_load(&etat->premier);
+                printf("[Consommateur] Segment %llu supprimé : reprise au message %llu.\n",
+                       (unsigned long long) base, (unsigned long long) premier);
+                while (lecteur_placer(&l, premier, 0) == -1 && !stop) sleep(1);
+            }
+            continue;
+        }
+        // 'tete' dit jusqu'où les messages sont publiés (et non une longueur
+        // non nulle, qui peut aussi être un reste d'une vie précédente).
+        uint64_t reprise = atomic_load_explicit(&etat->reprise, memory_order_acquire);
+        if (reprise != reprise_vue) {
+            // Producteur relancé. S'il est reparti en deçà de notre position
+            // (panne : la fin non durable est perdue), les numéros à partir de
+            // 'reprise' sont de nouveaux messages : on les lit.
+            reprise_vue = reprise;
+            if (reprise < l.suivant) {
+                printf("[Consommateur] Registre repris au message %llu (panne du producteur) : on s'y replace.\n",
+                       (unsigned long long) reprise);
+                while (lecteur_placer(&l, reprise, 0) == -1 && !stop) sleep(1);
+                continue;
+            }
+        }
+        uint64_t tete = atomic_load_explicit(&etat->tete, memory_order_acquire);
+        if (l.suivant >= tete) {
+            // Rien de nouveau : on dort (au plus PERIODE_TUBE_NS, pour le tube
+            // et la validation) jusqu'à ce que le producteur publie.
+            unsigned int s = parking_preparer(&etat->parking_conso);
+            if (atomic_load_explicit(&etat->tete, memory_order_seq_cst) == tete && !stop)
+                futex_attendre_delai(&etat->parking_conso.signal, s, PERIODE_TUBE_NS, 0);
+            parking_annuler(&etat->parking_conso);
+            continue;
+        }
+        uint32_t longueur = message_lisible(&l.seg, l.position, l.suivant);
+        if (longueur == 0) {
+            // Publié, mais pas là où on l'attend : le producteur a été relancé
+            // après une panne et a réécrit la fin du registre. On laisse sa
+            // reprise finir, puis on se replace par l'index.
+            fprintf(stderr, "[Consommateur] Message %llu introuvable (segment %llu, octet %zu) : on se replace.\n",
+                    (unsigned long long) l.suivant, (unsigned long long) l.seg.base, l.position);
+            sleep(1);
+            while (lecteur_placer(&l, l.suivant, 0) == -1 && !stop) sleep(1);
+            continue;
+        }
+        const char *texte = (const char *) (h + 1);
+        if (h->controle != somme_controle(texte, longueur)) {
+            fprintf(stderr, "[Consommateur] Message %llu corrompu, ignoré.\n", (unsigned long long) h->sequence);
+        } else if (!silencieux) {
+            printf("<- Conso : Lu '%s' (seq %llu)\n", texte, (unsigned long long) h->sequence);
+        }
+        l.suivant++;
+        l.position += taille_msg(longueur);
+        lus++;
+    }
+
+    // 4. DERNIÈRE VALIDATION : au prochain lancement, on reprendra ici.
+    valide_jusqua = valider(fd_pos, l.suivant, etat);
+    double secondes = (horloge_ns() - debut) / 1e9;
+    printf("\n[Consommateur] Fin. %llu message(s) en %.2f s (%.0f msg/s), position validée : %llu.\n",
+           lus, secondes, lus / secondes, (unsigned long long) valide_jusqua);
+
+    segment_fermer(&l.seg);
+    munmap(etat, sizeof(Etat));
+    close(fd_pos);
+    recepteur_fermer(&tube, FIFO_CONSO);
+
+    return 0;
+}
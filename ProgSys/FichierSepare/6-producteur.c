@@ -0,0 +1,345 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>       // Pause de démonstration interrompue par une commande
+#include <getopt.h>     // Lecture des options -d -t -s -g -p -q
+#include "6-common.h"
+
+// Variable globale modifiée par le handler de signal (interruption).
+volatile sig_atomic_t stop = 0;
+
+// Handler exécuté lors de la réception de SIGINT (Ctrl+C)
+void handler(int sig) {
+    stop = 1;
+}
+
+// --- CÔTÉ ÉCRIVAIN DU REGISTRE ---
+typedef struct {
+    const char *dossier;
+    int fd_dossier;             // Pour rendre durable la création d'un segment (fsync du dossier)
+    Etat *etat;
+    Segment seg;                // Segment en cours d'écriture
+    size_t position;            // Prochain octet libre dans le segment
+    size_t synchronise;         // Octets du segment déjà rendus durables
+    size_t prochain_index;      // Position à partir de laquelle ajouter une entrée d'index
+    uint64_t sequence;          // Numéro du prochain message
+    int garder;                 // Segments conservés
+    // Bilan des synchronisations
+    unsigned long syncs;
+    uint64_t sync_ns, sync_max_ns;
+} Registre;
+
+// Ajoute une entrée à l'index du segment pour le message à 'position'.
+static void indexer(Registre *r, const EnTeteMsg *h) {
+    Index *ix = r->seg.index;
+    uint64_t n = atomic_load_explicit(&ix->nombre, memory_order_relaxed);
+    ix->e[n].sequence = h->sequence;
+    ix->e[n].horodatage = h->horodatage;
+    ix->e[n].position = r->position;
+    atomic_store_explicit(&ix->nombre, n + 1, memory_order_release);
+    r->prochain_index = (r->position / PAS_INDEX + 1) * PAS_INDEX;
+}
+
+// Rend durable tout ce qui a été écrit depuis la dernière fois.
+// msync(MS_SYNC) écrit les pages modifiées de la plage ET attend le disque
+// (l'équivalent d'un fdatasync limité à cette plage) : UN appel par intervalle,
+// quel que soit le nombre de messages ajoutés entre-temps.
+static void registre_synchroniser(Registre *r) {
+    if (r->position > r->synchronise) {
+        uint64_t debut = horloge_ns();
+        size_t page = (size_t) sysconf(_SC_PAGESIZE);
+        size_t depart = r->synchronise & ~(page - 1);
+        msync(r->seg.octets + depart, r->position - depart, MS_SYNC);
+        msync(r->seg.index, taille_index(r->seg.taille), MS_SYNC);
+        r->synchronise = r->position;
+        uint64_t duree = horloge_ns() - debut;
+        r->syncs++;
+        r->sync_ns += duree;
+        if (duree > r->sync_max_ns) r->sync_max_ns = duree;
+    }
+    atomic_store_explicit(&r->etat->durable, r->sequence, memory_order_release);
+}
+
+// Rétention : supprime les plus vieux segments au-delà de 'garder'.
+// Un consommateur qui lit encore un fichier supprimé garde sa projection ;
+// il ne perd que ce qu'il n'a pas encore atteint.
+static void registre_elaguer(Registre *r) {
+    uint64_t *bases;
+    int n = segments_lister(r->dossier, &bases);
+    if (n < 0) return;
+    int k = 0;
+    for (; n - k > r->garder; k++) {
+        char chemin[4096];
+        chemin_segment(chemin, sizeof(chemin), r->dossier, bases[k], "seg");
+        unlink(chemin);
+        chemin_segment(chemin, sizeof(chemin), r->dossier, bases[k], "idx");
+        unlink(chemin);
+    }
+    if (k < n) atomic_store_explicit(&r->etat->premier, bases[k], memory_order_release);
+    free(bases);
+}
+
+// Passe au segment suivant : il est créé (et son nom rendu durable) AVANT que
+// l'ancien ne reçoive sa marque FIN_SEGMENT, pour qu'un consommateur qui voit
+// la marque trouve toujours le fichier suivant.
+static int registre_rouler(Registre *r) {
+    Segment nouveau;
+    if (segment_ouvrir(&nouveau, r->dossier, r->sequence, r->seg.taille, 1) == -1) return -1;
+    fsync(r->fd_dossier);
+
+    EnTeteMsg *fin = message_a(&r->seg, r->position);
+    fin->sequence = r->sequence;                // Où continuer
+    atomic_store_explicit(&fin->longueur, FIN_SEGMENT, memory_order_release);
+    etat_reveiller(r->etat);
+
+    // L'ancien segment est complet : on le rend durable en entier maintenant.
+    r->position += sizeof(EnTeteMsg);
+    registre_synchroniser(r);
+    segment_fermer(&r->seg);
+
+    r->seg = nouveau;
+    r->position = 0;
+    r->synchronise = 0;
+    r->prochain_index = 0;
+    registre_elaguer(r);
+    return 0;
+}
+
+// Ajoute un message (chemin chaud : une copie, aucun appel système).
+static int registre_ajouter(Registre *r, const char *texte) {
+    size_t longueur = strlen(texte) + 1;
+    // On garde toujours la place d'une marque FIN_SEGMENT derrière le message.
+    if (r->position + taille_msg(longueur) + sizeof(EnTeteMsg) > r->seg.taille
+        && registre_rouler(r) == -1) return -1;
+
+    EnTeteMsg *h = message_a(&r->seg, r->position);
+    h->sequence = r->sequence;
+    h->horodatage = horloge_reelle_ns();
+    h->controle = somme_controle(texte, longueur);
+    memcpy(h + 1, texte, longueur);
+    // Publication : la longueur en dernier, le message devient lisible.
+    atomic_store_explicit(&h->longueur, (uint32_t) longueur, memory_order_release);
+    if (r->position >= r->prochain_index) indexer(r, h);
+
+    r->position += taille_msg(longueur);
+    r->sequence++;
+    atomic_store_explicit(&r->etat->tete, r->sequence, memory_order_release);
+    etat_reveiller(r->etat);
+    return 0;
+}
+
+// Reprise après un arrêt (ou une panne) : on repart de la dernière entrée de
+// l'index du dernier segment et on avance tant que les messages sont complets.
+// Un message dont la somme de contrôle est fausse a été coupé par la panne :
+// il est effacé avec TOUTE la fin du segment, et l'écriture reprend à sa place.
+static void registre_reprendre(Registre *r) {
+    Index *ix = r->seg.index;
+    // L'index a pu atteindre le disque avant les données : on retire ses
+    // entrées qui désignent un message absent ou incomplet.
+    uint64_t n = atomic_load(&ix->nombre);
+    while (n > 0 && !message_valide(&r->seg, ix->e[n - 1].position, ix->e[n - 1].sequence)) n--;
+    atomic_store(&ix->nombre, n);
+
+    r->sequence = n > 0 ? ix->e[n - 1].sequence : r->seg.base;
+    r->position = n > 0 ? ix->e[n - 1].position : 0;
+    while (message_valide(&r->seg, r->position, r->sequence)) {
+        r->position += taille_msg(atomic_load(&message_a(&r->seg, r->position)->longueur));
+        r->sequence++;
+    }
+    // Efface la fin du segment : un message incomplet, une marque de fin
+    // orpheline, mais aussi les restes d'une vie précédente plus loin (des
+    // en-têtes qu'un lecteur prendrait pour les nôtres une fois réécrits autour).
+    // Le début de page est mis à zéro, les pages suivantes sont rendues au
+    // système de fichiers (le fichier reste creux) ; à défaut, tout à zéro.
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t fin_page = (r->position + page - 1) & ~(page - 1);
+    if (fin_page > r->seg.taille) fin_page = r->seg.taille;
+    memset(r->seg.octets + r->position, 0, fin_page - r->position);
+    if (fin_page < r->seg.taille
+        && madvise(r->seg.octets + fin_page, r->seg.taille - fin_page, MADV_REMOVE) == -1)
+        memset(r->seg.octets + fin_page, 0, r->seg.taille - fin_page);
+    r->prochain_index = n > 0 ? (ix->e[n - 1].position / PAS_INDEX + 1) * PAS_INDEX : 0;
+    r->synchronise = r->position;
+}
+
+// Usage : ./6-producteur [-d dossier] [-t taille_segment] [-s sync_ms] [-g garder] [-p pause_ms] [-q]
+//   -d : dossier du registre (/tmp/registre_v6 par défaut), conservé à l'arrêt
+//   -t : taille d'un fichier segment en octets (4 Mio par défaut ; un registre
+//        existant garde la taille avec laquelle il a été créé)
+//   -s : intervalle entre deux synchronisations disque (200 ms par défaut)
+//   -g : nombre de segments conservés (8 par défaut)
+//   -p : pause entre deux messages (1000 ms par défaut, 0 = à pleine vitesse)
+//   -q : n'affiche pas chaque message (seulement le bilan)
+int main(int argc, char *argv[]) {
+    const char *dossier = DOSSIER_DEFAUT;
+    unsigned long taille_segment = TAILLE_SEGMENT_DEFAUT;
+    int sync_ms = SYNC_DEFAUT_MS;
+    int garder = GARDER_DEFAUT;
+    int pause_ms = PAUSE_DEMO_MS;
+    int silencieux = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "d:t:s:g:p:q")) != -1) {
+        if (opt == 'd') dossier = optarg;
+        else if (opt == 't') taille_segment = strtoul(optarg, NULL, 10);
+        else if (opt == 's') sync_ms = atoi(optarg);
+        else if (opt == 'g') garder = atoi(optarg);
+        else if (opt == 'p') pause_ms = atoi(optarg);
+        else if (opt == 'q') silencieux = 1;
+        else exit(1);
+    }
+    if (taille_segment < TAILLE_SEGMENT_MIN || taille_segment > TAILLE_SEGMENT_MAX
+        || sync_ms <= 0 || garder < 1 || pause_ms < 0) {
+        fprintf(stderr, "Usage : %s [-d dossier] [-t taille_segment %lu..%lu] [-s sync_ms > 0] "
+                "[-g garder >= 1] [-p pause_ms] [-q]\n", argv[0], TAILLE_SEGMENT_MIN, TAILLE_SEGMENT_MAX);
+        exit(1);
+    }
+    taille_segment &= ~(unsigned long) (ALIGNEMENT - 1);
+
+    // =================================================================
+    // 1. CONFIGURATION DES SIGNAUX
+    // =================================================================
+    struct sigaction psa;
+    psa.sa_handler = handler;
+    sigemptyset(&psa.sa_mask);
+    psa.sa_flags = 0;
+    sigaction(SIGINT, &psa, NULL);
+
+    // =================================================================
+    // 2. OUVERTURE (OU REPRISE) DU REGISTRE
+    // =================================================================
+    Registre r;
+    memset(&r, 0, sizeof(r));
+    r.dossier = dossier;
+    r.garder = garder;
+    mkdir(dossier, 0777);
+    r.fd_dossier = open(dossier, O_RDONLY | O_DIRECTORY);
+    r.etat = etat_ouvrir(dossier, 1);
+    if (r.fd_dossier == -1 || r.etat == NULL) {
+        perror("Erreur ouverture du registre");
+        exit(1);
+    }
+    Etat *etat = r.etat;
+    if (atomic_load(&etat->magique) == MAGIQUE_V6 && etat->version == VERSION_LAYOUT
+        && etat->taille_segment != taille_segment) {
+        printf("[Producteur] Registre existant : segments de %llu octets conservés.\n",
+               (unsigned long long) etat->taille_segment);
+        taille_segment = etat->taille_segment;
+    }
+
+    uint64_t *bases;
+    int n = segments_lister(dossier, &bases);
+    uint64_t base = (n > 0) ? bases[n - 1] : 0;
+    if (n > 0) atomic_store(&etat->premier, bases[0]);
+    else atomic_store(&etat->premier, 0);
+    free(bases);
+    if (segment_ouvrir(&r.seg, dossier, base, taille_segment, 1) == -1) {
+        perror("Erreur ouverture du segment");
+        exit(1);
+    }
+    registre_reprendre(&r);
+
+    etat->version = VERSION_LAYOUT;
+    etat->taille_segment = taille_segment;
+    atomic_store(&etat->tete, r.sequence);
+    atomic_store(&etat->durable, r.sequence);
+    // Après une panne, r.sequence peut être en deçà de l'ancienne tête : les
+    // numéros suivants désignent des messages NOUVEAUX. 'reprise' (écrite
+    // après 'tete') prévient les consommateurs déjà plus loin.
+    atomic_store(&etat->reprise, r.sequence);
+    atomic_store_explicit(&etat->magique, MAGIQUE_V6, memory_order_release);
+    uint64_t depart = r.sequence;
+
+    // =================================================================
+    // 3. MISE EN PLACE DU TUBE NOMMÉ (FIFO) : commandes en trames
+    // =================================================================
+    Recepteur tube;
+    if (recepteur_ouvrir(&tube, FIFO_PROD) == -1) {
+        perror("Avertissement : Erreur ouverture FIFO");
+    }
+
+    printf("--- Producteur V6 (Registre durable) Démarré : %s, segments de %lu octets, "
+           "reprise au message %llu (segment %llu, octet %zu) ---\n",
+           dossier, taille_segment, (unsigned long long) r.sequence,
+           (unsigned long long) r.seg.base, r.position);
+
+    char message_actuel[CONTROLE_MAX];
+    snprintf(message_actuel, sizeof(message_actuel), "Defaut");
+
+    uint64_t debut = horloge_ns();
+    uint64_t prochaine_sync = debut + (uint64_t) sync_ms * 1000000ULL;
+    uint64_t prochain_tube = 0;
+    uint64_t reprise = 0;       // Heure du prochain message (rythme de démonstration)
+
+    // BOUCLE PRINCIPALE
+    while (!stop) {
+        uint64_t maintenant = horloge_ns();
+
+        // A. COMMANDES DU COMMUNICANT
+        // À pleine vitesse, le tube n'est lu qu'une fois par PERIODE_TUBE_NS.
+        if (pause_ms > 0 || maintenant >= prochain_tube) {
+            prochain_tube = maintenant + PERIODE_TUBE_NS;
+            char buffer_cmd[CONTROLE_MAX];
+            while (recepteur_lire(&tube, buffer_cmd, sizeof(buffer_cmd))) {
+                printf("\n[COMMANDE REÇUE] : '%s'\n", buffer_cmd);
+                if (strcmp(buffer_cmd, "stop") == 0) {
+                    printf("Ordre d'arrêt reçu.\n");
+                    stop = 1;
+                    break;
+                }
+                snprintf(message_actuel, sizeof(message_actuel), "%s", buffer_cmd);
+            }
+            if (stop) break;
+        }
+
+        // B. DURABILITÉ PAR LOTS
+        if (maintenant >= prochaine_sync) {
+            registre_synchroniser(&r);
+            prochaine_sync = maintenant + (uint64_t) sync_ms * 1000000ULL;
+        }
+
+        // C. PAUSE DE DÉMONSTRATION : on dort jusqu'au prochain message ou à la
+        //    prochaine synchronisation ; une commande sur le tube nous réveille.
+        if (maintenant < reprise) {
+            uint64_t limite = reprise < prochaine_sync ? reprise : prochaine_sync;
+            struct pollfd pfd = { tube.fd, POLLIN, 0 };
+            poll(&pfd, tube.fd != -1 ? 1 : 0, (int) ((limite - maintenant + 999999) / 1000000));
+            continue;
+        }
+
+        // D. PRODUCTION : ajout en fin de segment
+        char texte[TAILLE_MSG_MAX];
+        snprintf(texte, sizeof(texte), "%s-%llu", message_actuel, (unsigned long long) r.sequence);
+        if (registre_ajouter(&r, texte) == -1) {
+            perror("Erreur création d'un segment");
+            break;
+        }
+        if (!silencieux) {
+            printf("-> Prod : Ecrit '%s' (seq %llu, segment %llu)\n", texte,
+                   (unsigned long long) r.sequence - 1, (unsigned long long) r.seg.base);
+        }
+        if (pause_ms > 0) reprise = horloge_ns() + (uint64_t) pause_ms * 1000000ULL;
+    }
+
+    // =================================================================
+    // 4. ARRÊT : tout est rendu durable, les fichiers sont CONSERVÉS
+    // =================================================================
+    registre_synchroniser(&r);
+    double secondes = (horloge_ns() - debut) / 1e9;
+    unsigned long long ecrits = r.sequence - depart;
+    printf("\n[Producteur] Fin. %llu message(s) en %.2f s (%.0f msg/s), %lu synchronisation(s)",
+           ecrits, secondes, ecrits / secondes, r.syncs);
+    if (r.syncs > 0)
+        printf(" : %.2f ms en moyenne, %.2f ms au pire", r.sync_ns / 1e6 / r.syncs, r.sync_max_ns / 1e6);
+    printf(".\n[Producteur] Registre conservé dans %s (messages %llu à %llu).\n", dossier,
+           (unsigned long long) atomic_load(&etat->premier), (unsigned long long) r.sequence - 1);
+
+    segment_fermer(&r.seg);
+    munmap(etat, sizeof(Etat));
+    close(r.fd_dossier);
+    recepteur_fermer(&tube, FIFO_PROD);
+
+    return 0;
+}
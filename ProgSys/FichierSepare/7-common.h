@@ -0,0 +1,347 @@
+#ifndef COMMON_H
+#define COMMON_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdatomic.h>
+#include "../Outils/futex.h"   // Parking (futex) placé DANS le segment partagé
+#include "../Outils/histo.h"   // horloge_ns (rapports périodiques)
+#include "../Outils/controle.h" // Trames de commande sur le tube du producteur
+
+// =================================================================
+// VERSION 7 : PARTITIONS (K anneaux indépendants dans un seul segment)
+// =================================================================
+// Un seul anneau protégé par un seul verrou (V3) n'occupe guère plus de deux
+// cœurs : tous les consommateurs se disputent la même file. Ici, le segment
+// contient K anneaux SPSC (ceux de la V4 : séquences + futex, sans verrou) :
+//   - le producteur range chaque message dans la partition hash(clé) % K, où
+//     la clé est le préfixe avant "-%d" : tous les messages d'une même clé
+//     passent par la même partition, DANS L'ORDRE ;
+//   - chaque consommateur est attaché à UNE partition (-s) : K consommateurs
+//     travaillent en parallèle sans jamais partager une ligne de cache.
+// Chaque partition compte ce qu'elle reçoit et combien de fois elle était
+// pleine : une clé "chaude" se voit tout de suite dans le rapport.
+//
+// Mode GABARIT (-t) : un message vaut toujours "<préfixe>[<n° de clé>]-<compteur>",
+// et le préfixe ne change que sur commande du communicant. Au lieu de recopier
+// le texte rendu (snprintf, 64 octets par case), le producteur range le préfixe
+// UNE fois dans la table 'prefixes' du segment et chaque case ne porte que
+// (indice du préfixe, n° de clé, compteur) : 16 octets, 4 messages par ligne de
+// cache au lieu d'un. Le consommateur ne reconstitue le texte que s'il doit
+// l'afficher ou l'écrire (gabarit_rendre).
+
+#define PARTITIONS_DEFAUT 4
+#define PARTITIONS_MAX 64
+#define CAPACITE_DEFAUT 256       // Cases par partition (arrondi à une puissance de 2)
+#define CAPACITE_MAX (1UL << 20)
+#define TAILLE_CASE 64            // Octets par message ('\0' compris)
+// Préfixe d'un message ('\0' compris) : le reste de la case garde la place de
+// la clé (4 chiffres) et de "-<compteur>" (20), pour que le texte ne soit
+// jamais tronqué (sinon le hachage et l'ordre porteraient sur une autre clé).
+#define PREFIXE_MAX (TAILLE_CASE - 32)
+#define PREFIXES_MAX 256          // Préfixes différents (mode gabarit) pour toute la vie du segment
+#define TAILLE_LIGNE 64
+#define PAUSE_DEMO_MS 1000        // Rythme de démonstration : un message par seconde
+#define PERIODE_TUBE_NS 100000000ULL    // Lecture du tube au plus toutes les 100 ms
+#define ATTENTE_PLEINE_NS 1000000000ULL // Attente max sur une partition pleine avant de revoir tube et rapport
+
+#define MAGIQUE_V7 0x37545250u    // "PRT7" en mémoire
+#define VERSION_LAYOUT 2
+
+#define SHM_NAME "/mon_shm_v7"
+// Seul le producteur reçoit des commandes (nouvelle clé, "stop") ; les
+// consommateurs s'arrêtent quand il ferme le segment.
+#define FIFO_PROD "/tmp/fifo_prod_v3"
+
+// --- UN MESSAGE EN MODE GABARIT ---
+// Rendu : "<prefixes[prefixe]><cle>-<compteur>", ou "<prefixes[prefixe]>-<compteur>" si cle = -1.
+typedef struct {
+    uint32_t prefixe;           // Indice dans la table des préfixes du segment
+    int32_t cle;                // N° de clé (option -n du producteur), -1 : aucun
+    int64_t compteur;
+} Gabarit;
+
+// --- UNE PARTITION ---
+// 'tete' / 'queue' : séquences qui ne reviennent jamais à 0 (comme en V4).
+// Chaque champ écrit par un seul côté a sa propre ligne de cache.
+typedef struct {
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long tete;     // Producteur
+    _Atomic uint64_t pleine;                               // Producteur : fois où il a trouvé la partition pleine
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long queue;    // Consommateur
+    _Atomic int32_t consommateur;                          // pid du consommateur attaché (0 : aucun)
+    _Alignas(TAILLE_LIGNE) Parking parking_prod;           // Le producteur dort ici si elle est pleine
+    _Alignas(TAILLE_LIGNE) Parking parking_conso;          // Son consommateur dort ici si elle est vide
+} Partition;
+
+// --- STRUCTURE DE LA MÉMOIRE PARTAGÉE (Layout V7) ---
+// En-tête (avec la table des préfixes), puis les K partitions, puis les
+// K * capacite cases.
+typedef struct {
+    _Atomic uint32_t magique;   // Écrit EN DERNIER : segment prêt
+    uint32_t version;
+    uint64_t partitions;
+    uint64_t capacite;          // Cases par partition (puissance de 2)
+    uint64_t masque;
+    uint64_t taille_case;       // TAILLE_CASE (texte) ou sizeof(Gabarit)
+    uint64_t taille_totale;
+    uint32_t gabarits;          // 1 : les cases contiennent des Gabarit
+    _Atomic uint32_t fin;       // Le producteur est parti : vider puis s'arrêter
+    // Table des préfixes (mode gabarit). Écrite par le producteur seul, jamais
+    // modifiée une fois publiée : un préfixe est rangé AVANT la première case
+    // qui le cite, et la publication de cette case (release sur 'tete') le
+    // rend visible au consommateur avec elle.
+    _Atomic uint32_t nb_prefixes;
+    char prefixes[PREFIXES_MAX][PREFIXE_MAX];
+    _Alignas(TAILLE_LIGNE) Partition p[];
+} MemoirePartagee;
+
+static inline uint64_t puissance2_sup(uint64_t n) {
+    uint64_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+static inline size_t taille_segment(uint64_t partitions, uint64_t capacite, uint64_t taille_case) {
+    return sizeof(MemoirePartagee) + partitions * sizeof(Partition) + partitions * capacite * taille_case;
+}
+
+// Case de la séquence 'seq' dans la partition 'k'.
+static inline char *case_de(MemoirePartagee *shm, uint64_t k, unsigned long seq) {
+    unsigned char *cases = (unsigned char *) &shm->p[shm->partitions];
+    return (char *) cases + ((k * shm->capacite) + (seq & shm->masque)) * shm->taille_case;
+}
+
+// Partition d'une clé : FNV-1a de la clé (le texte AVANT le dernier '-').
+// Même clé -> même partition -> ordre conservé pour cette clé.
+static inline uint64_t partition_de(const char *message, uint64_t partitions) {
+    const char *fin = strrchr(message, '-');
+    size_t n = fin != NULL ? (size_t) (fin - message) : strlen(message);
+    uint32_t h = 2166136261u;
+    for (size_t k = 0; k < n; k++) h = (h ^ (unsigned char) message[k]) * 16777619u;
+    return h % partitions;
+}
+
+// Partition d'une clé en mode gabarit : la MÊME que pour le texte rendu (un
+// consommateur voit les mêmes clés dans les deux modes). Le producteur la
+// calcule une fois par clé quand le préfixe change, pas à chaque message.
+// Préfixe borné à PREFIXE_MAX comme en mode texte : on hache la même clé.
+static inline uint64_t partition_de_gabarit(const char *prefixe, int cle, uint64_t partitions) {
+    char texte[TAILLE_CASE];
+    if (cle >= 0) snprintf(texte, sizeof(texte), "%.*s%d-", PREFIXE_MAX - 1, prefixe, cle);
+    else snprintf(texte, sizeof(texte), "%.*s-", PREFIXE_MAX - 1, prefixe);
+    return partition_de(texte, partitions);
+}
+
+// Producteur : indice de 'texte' dans la table des préfixes (ajouté s'il n'y
+// est pas encore). Renvoie -1 si la table est pleine. Seuls les PREFIXE_MAX - 1
+// premiers octets comptent : ce qu'une case texte peut contenir.
+static inline int prefixe_interner(MemoirePartagee *shm, const char *texte) {
+    uint32_t n = atomic_load_explicit(&shm->nb_prefixes, memory_order_relaxed);
+    for (uint32_t id = 0; id < n; id++)
+        if (strncmp(shm->prefixes[id], texte, PREFIXE_MAX - 1) == 0) return (int) id;
+    if (n == PREFIXES_MAX) return -1;
+    snprintf(shm->prefixes[n], PREFIXE_MAX, "%.*s", PREFIXE_MAX - 1, texte);
+    atomic_store_explicit(&shm->nb_prefixes, n + 1, memory_order_release);
+    return (int) n;
+}
+
+// Texte d'un message gabarit, tel que le producteur l'aurait écrit en mode texte.
+// Renvoie sa longueur (tronquée à 'taille' - 1).
+static inline size_t gabarit_rendre(const MemoirePartagee *shm, const Gabarit *g, char *texte, size_t taille) {
+    const char *prefixe = g->prefixe < PREFIXES_MAX ? shm->prefixes[g->prefixe] : "?";
+    int n;
+    if (g->cle >= 0) n = snprintf(texte, taille, "%s%d-%lld", prefixe, g->cle, (long long) g->compteur);
+    else n = snprintf(texte, taille, "%s-%lld", prefixe, (long long) g->compteur);
+    if (n < 0) return 0;
+    return (size_t) n < taille ? (size_t) n : taille - 1;
+}
+
+// Producteur : crée (ou recrée) le segment. Renvoie NULL en cas d'erreur.
+// 'gabarits' : 1 pour des cases Gabarit (16 octets) au lieu de texte (64).
+static inline MemoirePartagee *segment_creer(uint64_t partitions, uint64_t capacite, int gabarits,
+                                             size_t *taille) {
+    capacite = puissance2_sup(capacite);
+    uint64_t taille_case = gabarits ? sizeof(Gabarit) : TAILLE_CASE;
+    *taille = taille_segment(partitions, capacite, taille_case);
+    int fd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
+    if (fd == -1) {
+        perror("Erreur shm_open");
+        return NULL;
+    }
+    if (ftruncate(fd, *taille) == -1) {
+        perror("Erreur ftruncate");
+        close(fd);
+        return NULL;
+    }
+    MemoirePartagee *shm = mmap(NULL, *taille, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED) {
+        perror("Erreur mmap");
+        return NULL;
+    }
+    memset(shm, 0, sizeof(MemoirePartagee) + partitions * sizeof(Partition));
+    shm->version = VERSION_LAYOUT;
+    shm->partitions = partitions;
+    shm->capacite = capacite;
+    shm->masque = capacite - 1;
+    shm->taille_case = taille_case;
+    shm->gabarits = gabarits ? 1 : 0;
+    shm->taille_totale = *taille;
+    atomic_store_explicit(&shm->magique, MAGIQUE_V7, memory_order_release);
+    return shm;
+}
+
+// Consommateur : s'attache au segment (géométrie lue dans l'en-tête).
+static inline MemoirePartagee *segment_attacher(size_t *taille) {
+    int fd = shm_open(SHM_NAME, O_RDWR, 0666);
+    if (fd == -1) {
+        perror("Lancez le producteur avant");
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t) st.st_size < sizeof(MemoirePartagee)) {
+        fprintf(stderr, "Segment %s vide ou trop petit.\n", SHM_NAME);
+        close(fd);
+        return NULL;
+    }
+    *taille = st.st_size;
+    MemoirePartagee *shm = mmap(NULL, *taille, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED) {
+        perror("Erreur mmap");
+        return NULL;
+    }
+    if (atomic_load_explicit(&shm->magique, memory_order_acquire) != MAGIQUE_V7
+        || shm->version != VERSION_LAYOUT || shm->taille_totale != (uint64_t) st.st_size) {
+        fprintf(stderr, "Segment %s non reconnu (producteur V7 pas prêt ?).\n", SHM_NAME);
+        munmap(shm, *taille);
+        return NULL;
+    }
+    return shm;
+}
+
+// =================================================================
+// UNE PARTITION = UN ANNEAU SPSC (même protocole que la V4)
+// =================================================================
+
+// Producteur : prochaine case libre de la partition 'k' (attente seulement si
+// elle est VRAIMENT pleine ; les autres partitions attendent alors aussi :
+// une clé trop chaude freine tout le monde, d'où le compteur 'pleine').
+// '*queue_connue' : copie locale de la queue de cette partition.
+// Renvoie NULL avec errno = EINTR si '*stop' a été levé pendant l'attente, ou
+// errno = ETIMEDOUT si la partition est restée pleine ATTENTE_PLEINE_NS : un
+// consommateur arrêté ne doit pas priver le producteur de son tube (donc du
+// "stop") ni de son rapport ; l'appelant y retourne puis redemande la case
+// (chaque seconde de blocage compte alors dans 'pleine').
+// La case n'est visible du consommateur qu'après partition_publier.
+static inline char *partition_reserver(MemoirePartagee *shm, uint64_t k, unsigned long *queue_connue,
+                                       const volatile sig_atomic_t *stop) {
+    Partition *p = &shm->p[k];
+    unsigned long t = atomic_load_explicit(&p->tete, memory_order_relaxed);
+    if (t - *queue_connue >= shm->capacite) {
+        *queue_connue = atomic_load_explicit(&p->queue, memory_order_acquire);
+        if (t - *queue_connue >= shm->capacite)
+            atomic_store_explicit(&p->pleine, atomic_load_explicit(&p->pleine, memory_order_relaxed) + 1,
+                                  memory_order_relaxed);
+        uint64_t limite = 0;
+        while (t - *queue_connue >= shm->capacite) {
+            if (*stop) {
+                errno = EINTR;
+                return NULL;
+            }
+            uint64_t maintenant = horloge_ns();
+            if (limite == 0) limite = maintenant + ATTENTE_PLEINE_NS;
+            else if (maintenant >= limite) {
+                errno = ETIMEDOUT;
+                return NULL;
+            }
+            // Même protocole que parking_attendre, mais avec un délai.
+            unsigned int v = parking_preparer(&p->parking_prod);
+            if (atomic_load_explicit(&p->queue, memory_order_seq_cst) == *queue_connue && !*stop)
+                futex_attendre_delai(&p->parking_prod.signal, v, limite - maintenant, 0);
+            parking_annuler(&p->parking_prod);
+            *queue_connue = atomic_load_explicit(&p->queue, memory_order_acquire);
+        }
+    }
+    return case_de(shm, k, t);
+}
+
+static inline void partition_publier(MemoirePartagee *shm, uint64_t k) {
+    Partition *p = &shm->p[k];
+    atomic_store_explicit(&p->tete, atomic_load_explicit(&p->tete, memory_order_relaxed) + 1,
+                          memory_order_release);
+    parking_reveiller(&p->parking_conso, 0);
+}
+
+// Mode texte : dépose 'texte' dans la partition 'k'.
+// Renvoie 0, ou -1 (errno comme partition_reserver) si la case n'a pas été obtenue.
+static inline int partition_deposer(MemoirePartagee *shm, uint64_t k, const char *texte,
+                                    unsigned long *queue_connue, const volatile sig_atomic_t *stop) {
+    char *c = partition_reserver(shm, k, queue_connue, stop);
+    if (c == NULL) return -1;
+    snprintf(c, TAILLE_CASE, "%s", texte);
+    partition_publier(shm, k);
+    return 0;
+}
+
+// Consommateur : prochain message de la partition 'k' (attente si vide).
+// Renvoie NULL si '*stop' a été levé, ou si le producteur est parti et que
+// la partition est vide. Le message reste dans la case jusqu'à partition_liberer
+// (en mode gabarit, la case est un Gabarit : cf. gabarit_rendre).
+static inline const char *partition_lire(MemoirePartagee *shm, uint64_t k, unsigned long *tete_connue,
+                                         const volatile sig_atomic_t *stop) {
+    Partition *p = &shm->p[k];
+    unsigned long q = atomic_load_explicit(&p->queue, memory_order_relaxed);
+    while (q == *tete_connue) {
+        *tete_connue = atomic_load_explicit(&p->tete, memory_order_acquire);
+        if (q != *tete_connue) break;
+        if (*stop || atomic_load(&shm->fin)) return NULL;
+        // 'fin' est relu APRÈS s'être déclaré endormi : le producteur lève
+        // 'fin' puis secoue le parking, l'un des deux voit forcément l'autre.
+        unsigned int v = parking_preparer(&p->parking_conso);
+        if (atomic_load_explicit(&p->tete, memory_order_seq_cst) == q && !*stop && !atomic_load(&shm->fin))
+            parking_dormir(&p->parking_conso, v, 0);
+        else
+            parking_annuler(&p->parking_conso);
+    }
+    return case_de(shm, k, q);
+}
+
+// Vrai si la partition 'k' n'a rien à lire (sans attendre).
+static inline int partition_vide(MemoirePartagee *shm, uint64_t k, unsigned long *tete_connue) {
+    Partition *p = &shm->p[k];
+    unsigned long q = atomic_load_explicit(&p->queue, memory_order_relaxed);
+    if (q != *tete_connue) return 0;
+    *tete_connue = atomic_load_explicit(&p->tete, memory_order_acquire);
+    return q == *tete_connue;
+}
+
+// Partition vide : dort au plus 'delai_ns' en attendant un message (même
+// protocole que partition_lire). Sert au consommateur qui a un lot en attente
+// d'écriture : il ne doit pas dormir plus longtemps que l'âge maximal du lot.
+static inline void partition_guetter(MemoirePartagee *shm, uint64_t k, const volatile sig_atomic_t *stop,
+                                     uint64_t delai_ns) {
+    Partition *p = &shm->p[k];
+    unsigned long q = atomic_load_explicit(&p->queue, memory_order_relaxed);
+    unsigned int v = parking_preparer(&p->parking_conso);
+    if (atomic_load_explicit(&p->tete, memory_order_seq_cst) == q && !*stop && !atomic_load(&shm->fin))
+        futex_attendre_delai(&p->parking_conso.signal, v, delai_ns, 0);
+    parking_annuler(&p->parking_conso);
+}
+
+static inline void partition_liberer(MemoirePartagee *shm, uint64_t k) {
+    Partition *p = &shm->p[k];
+    atomic_store_explicit(&p->queue, atomic_load_explicit(&p->queue, memory_order_relaxed) + 1,
+                          memory_order_release);
+    parking_reveiller(&p->parking_prod, 0);
+}
+
+#endif
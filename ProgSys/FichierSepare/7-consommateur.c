@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>     // Lecture des options -s -w -q -o -b -f
+#include "7-common.h"
+#include "../Outils/sortie.h"  // Sortie groupée (writev) des messages lus
+
+#define SUIVI_MAX 4096  // Clés suivies pour vérifier l'ordre (table à adressage ouvert)
+
+volatile sig_atomic_t stop = 0;
+Parking *mon_parking = NULL;    // Parking de notre partition (réveil par le handler)
+
+void handler(int sig) {
+    stop = 1;
+    if (mon_parking != NULL) parking_secouer(mon_parking, 0);
+}
+
+// --- VÉRIFICATION DE L'ORDRE PAR CLÉ ---
+// Pour chaque clé, le compteur "<clé>-<n>" doit se suivre : c'est la promesse
+// du partitionnement (une clé = une partition = une file ordonnée).
+typedef struct {
+    char cle[TAILLE_CASE];
+    long suivant;
+} Suivi;
+
+static Suivi suivi[SUIVI_MAX];
+static unsigned long hors_ordre = 0;
+
+static void verifier_ordre(const char *message) {
+    const char *tiret = strrchr(message, '-');
+    if (tiret == NULL) return;
+    size_t n = (size_t) (tiret - message);
+    long valeur = atol(tiret + 1);
+    uint32_t h = 2166136261u;
+    for (size_t k = 0; k < n; k++) h = (h ^ (unsigned char) message[k]) * 16777619u;
+    for (unsigned long essai = 0; essai < SUIVI_MAX; essai++) {
+        Suivi *s = &suivi[(h + essai) % SUIVI_MAX];
+        if (s->cle[0] == '\0') {
+            memcpy(s->cle, message, n);
+            s->cle[n] = '\0';
+            s->suivant = valeur + 1;
+            return;
+        }
+        if (strncmp(s->cle, message, n) == 0 && s->cle[n] == '\0') {
+            // Un compteur remis à 0 (nouvelle clé du communicant) n'est pas une erreur.
+            if (valeur != s->suivant && valeur != 0) hors_ordre++;
+            s->suivant = valeur + 1;
+            return;
+        }
+    }
+}
+
+// Même vérification en mode gabarit, SANS rendre le texte : la clé est le
+// couple (préfixe, n° de clé), le compteur est lu tel quel.
+typedef struct {
+    uint64_t cle;               // (prefixe << 32) | (n° de clé + 1) ; 0 : libre
+    long suivant;
+} SuiviGabarit;
+
+static SuiviGabarit suivi_gabarit[SUIVI_MAX];
+
+static void verifier_gabarit(const Gabarit *g) {
+    uint64_t cle = ((uint64_t) g->prefixe << 32) | (uint32_t) (g->cle + 1);
+    if (cle == 0) cle = 1;      // Préfixe 0 sans n° de clé : 0 est réservé aux places libres
+    uint64_t h = cle * 0x9E3779B97F4A7C15ULL;
+    for (unsigned long essai = 0; essai < SUIVI_MAX; essai++) {
+        SuiviGabarit *s = &suivi_gabarit[((h >> 32) + essai) % SUIVI_MAX];
+        if (s->cle == 0) {
+            s->cle = cle;
+            s->suivant = (long) g->compteur + 1;
+            return;
+        }
+        if (s->cle == cle) {
+            if (g->compteur != s->suivant && g->compteur != 0) hors_ordre++;
+            s->suivant = (long) g->compteur + 1;
+            return;
+        }
+    }
+}
+
+// Traitement simulé : 'travail_ns' de calcul par message (sans dormir).
+static void travailler(uint64_t travail_ns) {
+    if (travail_ns == 0) return;
+    uint64_t fin = horloge_ns() + travail_ns;
+    while (horloge_ns() < fin) { }
+}
+
+// Usage : ./7-consommateur -s partition [-w travail_us] [-q] [-o fichier [-b seuil_ko] [-f delai_ms]]
+//   -s : partition traitée par ce consommateur (une seule, un consommateur par partition)
+//   -w : temps de calcul simulé par message, en µs (0 par défaut)
+//   -q : n'affiche pas chaque message (seulement le bilan)
+//   -o : enregistre chaque message (une ligne) dans 'fichier' ("-" = stdout) par
+//        lots, au lieu d'un printf par message (cf. Outils/sortie.h)
+//   -b : taille d'un lot en Ko (1024 par défaut)
+//   -f : âge maximal d'un message non écrit, en ms (100 par défaut)
+// S'arrête quand le producteur s'arrête (après avoir vidé sa partition), ou sur Ctrl+C.
+int main(int argc, char *argv[]) {
+    long partition = -1;
+    uint64_t travail_ns = 0;
+    int silencieux = 0;
+    const char *chemin_sortie = NULL;
+    size_t seuil = SORTIE_SEUIL_DEFAUT;
+    int delai_ms = SORTIE_DELAI_DEFAUT_MS;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:w:qo:b:f:")) != -1) {
+        if (opt == 's') partition = atol(optarg);
+        else if (opt == 'w') travail_ns = (uint64_t) atol(optarg) * 1000;
+        else if (opt == 'q') silencieux = 1;
+        else if (opt == 'o') chemin_sortie = optarg;
+        else if (opt == 'b') seuil = (size_t) atol(optarg) << 10;
+        else if (opt == 'f') delai_ms = atoi(optarg);
+        else exit(1);
+    }
+    if (delai_ms < 0) {
+        fprintf(stderr, "Option -f : délai en ms, positif ou nul\n");
+        exit(1);
+    }
+
+    struct sigaction psa;
+    psa.sa_handler = handler;
+    sigemptyset(&psa.sa_mask);
+    psa.sa_flags = 0;
+    sigaction(SIGINT, &psa, NULL);
+
+    size_t taille;
+    MemoirePartagee *shm = segment_attacher(&taille);
+    if (shm == NULL) exit(1);
+    if (partition < 0 || (uint64_t) partition >= shm->partitions) {
+        fprintf(stderr, "Usage : %s -s partition (0..%llu) [-w travail_us] [-q]\n",
+                argv[0], (unsigned long long) shm->partitions - 1);
+        exit(1);
+    }
+
+    // Une partition = UN consommateur (anneau SPSC). La place d'un consommateur
+    // disparu sans se détacher (kill -9) est reprise.
+    Partition *p = &shm->p[partition];
+    int32_t pid = getpid(), ancien = 0;
+    while (!atomic_compare_exchange_strong(&p->consommateur, &ancien, pid)) {
+        if (kill(ancien, 0) == 0 || errno != ESRCH) {
+            fprintf(stderr, "La partition %ld est déjà traitée par le processus %d.\n", partition, ancien);
+            exit(1);
+        }
+    }
+    mon_parking = &p->parking_conso;
+
+    printf("--- Consommateur V7 (Partitions) Démarré : partition %ld / %llu%s ---\n",
+           partition, (unsigned long long) shm->partitions, shm->gabarits ? " (gabarits)" : "");
+
+    Sortie sortie;
+    if (chemin_sortie != NULL) {
+        if (sortie_ouvrir(&sortie, chemin_sortie, seuil, delai_ms) == -1) exit(1);
+        printf("Sortie : '%s' par lots de %lu Ko (ou toutes les %d ms)\n", chemin_sortie,
+               (unsigned long) (sortie.nb_blocs * SORTIE_BLOC) >> 10, delai_ms);
+        silencieux = 1;     // La sortie remplace l'affichage message par message
+    }
+    fflush(stdout);     // Si la sortie est stdout, l'en-tête doit passer AVANT le premier lot
+
+    unsigned long tete_connue = atomic_load(&p->tete);
+    unsigned long lus = 0;
+    uint64_t debut = horloge_ns();
+    while (!stop) {
+        // Plus rien à lire avec un lot en attente : on ne dort pas au-delà de
+        // son âge maximal, puis on l'écrit s'il a atteint cet âge.
+        if (chemin_sortie != NULL && sortie.en_attente > 0 &&
+            partition_vide(shm, (uint64_t) partition, &tete_connue)) {
+            uint64_t reste = sortie_reste_ns(&sortie);
+            if (reste > 0) partition_guetter(shm, (uint64_t) partition, &stop, reste);
+            sortie_echeance(&sortie);
+            // Toujours rien (délai écoulé, réveil sans message) : on recommence.
+            // Si le producteur a fini, partition_lire rend NULL tout de suite.
+            if (partition_vide(shm, (uint64_t) partition, &tete_connue) && !atomic_load(&shm->fin)) continue;
+        }
+        const char *item = partition_lire(shm, (uint64_t) partition, &tete_connue, &stop);
+        if (item == NULL) break;
+        // Mode gabarit : le texte n'est reconstitué que s'il sert (affichage, sortie).
+        char texte[TAILLE_CASE];
+        if (shm->gabarits) {
+            const Gabarit *g = (const Gabarit *) item;
+            verifier_gabarit(g);
+            if (chemin_sortie != NULL || !silencieux) {
+                gabarit_rendre(shm, g, texte, sizeof(texte));
+                item = texte;
+            }
+        } else {
+            verifier_ordre(item);
+        }
+        if (chemin_sortie != NULL) sortie_ecrire(&sortie, item, strnlen(item, TAILLE_CASE));
+        if (!silencieux) printf("<- Conso [%ld] : Lu '%s'\n", partition, item);
+        travailler(travail_ns);
+        partition_liberer(shm, (uint64_t) partition);
+        lus++;
+    }
+
+    double secondes = (horloge_ns() - debut) / 1e9;
+    printf("\n[Consommateur %ld] Fin. %lu message(s) en %.2f s (%.0f msg/s), ordre par clé %s",
+           partition, lus, secondes, lus / secondes, hors_ordre == 0 ? "respecté" : "VIOLÉ");
+    if (hors_ordre > 0) printf(" (%lu message(s) hors ordre)", hors_ordre);
+    printf(".\n");
+    fflush(stdout);
+    if (chemin_sortie != NULL) {
+        sortie_fermer(&sortie);
+        sortie_rapport(&sortie, "Sortie");
+    }
+
+    atomic_store(&p->consommateur, 0);
+    mon_parking = NULL;
+    munmap(shm, taille);
+    return 0;
+}
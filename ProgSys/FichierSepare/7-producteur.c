@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>       // Pause de démonstration interrompue par une commande
+#include <getopt.h>     // Lecture des options -k -c -n -p -i -q -t
+#include "7-common.h"
+
+#define CLES_MAX 1024
+
+volatile sig_atomic_t stop = 0;
+MemoirePartagee *partagee = NULL;
+
+void handler(int sig) {
+    stop = 1;
+    // On se secoue, quelle que soit la partition pleine sur laquelle on dort.
+    if (partagee != NULL)
+        for (uint64_t k = 0; k < partagee->partitions; k++) parking_secouer(&partagee->p[k].parking_prod, 0);
+}
+
+// Photo des partitions pour le rapport (débits = différence de deux photos).
+typedef struct {
+    uint64_t t;
+    unsigned long tete[PARTITIONS_MAX];
+    uint64_t pleine[PARTITIONS_MAX];
+} Releve;
+
+static void relever(MemoirePartagee *shm, Releve *r) {
+    r->t = horloge_ns();
+    for (uint64_t k = 0; k < shm->partitions; k++) {
+        r->tete[k] = atomic_load_explicit(&shm->p[k].tete, memory_order_relaxed);
+        r->pleine[k] = atomic_load_explicit(&shm->p[k].pleine, memory_order_relaxed);
+    }
+}
+
+// Une ligne par partition : débit reçu, occupation, fois où elle était pleine.
+// Une partition bien plus chargée que les autres = une clé (trop) chaude.
+static void rapport(MemoirePartagee *shm, const Releve *avant, const Releve *apres) {
+    double secondes = (apres->t - avant->t) / 1e9;
+    unsigned long total = 0;
+    for (uint64_t k = 0; k < shm->partitions; k++) total += apres->tete[k] - avant->tete[k];
+    printf("--- Partitions (%.2f s, %.0f msg/s au total) ---\n", secondes, total / secondes);
+    for (uint64_t k = 0; k < shm->partitions; k++) {
+        Partition *p = &shm->p[k];
+        unsigned long occupees = apres->tete[k] - atomic_load(&p->queue);
+        unsigned long recus = apres->tete[k] - avant->tete[k];
+        int pid = atomic_load(&p->consommateur);
+        printf("  [%2llu] %10.0f msg/s (%3.0f %%)  occupation %5lu / %lu (%3.0f %%)  pleine %6.0f/s  ",
+               (unsigned long long) k, recus / secondes, total ? 100.0 * recus / total : 0.0,
+               occupees, (unsigned long) shm->capacite, 100.0 * occupees / shm->capacite,
+               (apres->pleine[k] - avant->pleine[k]) / secondes);
+        if (pid != 0) printf("consommateur %d\n", pid);
+        else printf("AUCUN consommateur\n");
+    }
+    fflush(stdout);
+}
+
+// Usage : ./7-producteur [-k partitions] [-c capacite] [-n cles] [-p pause_ms] [-i rapport_ms] [-q] [-t]
+//   -k : nombre de partitions (4 par défaut, au plus 64)
+//   -c : cases par partition (256 par défaut)
+//   -n : nombre de clés produites à tour de rôle ("<texte>0", "<texte>1"...) ;
+//        0 (défaut) : une seule clé, le texte courant (changé par le communicant)
+//   -p : pause entre deux messages (1000 ms par défaut, 0 = pleine vitesse)
+//   -i : rapport par partition toutes les 'rapport_ms' (0 = seulement à la fin)
+//   -q : n'affiche pas chaque message
+//   -t : messages GABARITS (préfixe rangé une fois dans le segment, cases de
+//        16 octets) : plus de snprintf par message, 4 fois plus de messages par ligne
+// Lancer ensuite un ./7-consommateur -s <partition> par partition.
+int main(int argc, char *argv[]) {
+    unsigned long partitions = PARTITIONS_DEFAUT;
+    unsigned long capacite = CAPACITE_DEFAUT;
+    int cles = 0;
+    int pause_ms = PAUSE_DEMO_MS;
+    int rapport_ms = 0;
+    int silencieux = 0;
+    int gabarits = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "k:c:n:p:i:qt")) != -1) {
+        if (opt == 'k') partitions = strtoul(optarg, NULL, 10);
+        else if (opt == 'c') capacite = strtoul(optarg, NULL, 10);
+        else if (opt == 'n') cles = atoi(optarg);
+        else if (opt == 'p') pause_ms = atoi(optarg);
+        else if (opt == 'i') rapport_ms = atoi(optarg);
+        else if (opt == 'q') silencieux = 1;
+        else if (opt == 't') gabarits = 1;
+        else exit(1);
+    }
+    if (partitions < 1 || partitions > PARTITIONS_MAX || capacite < 1 || capacite > CAPACITE_MAX
+        || cles < 0 || cles > CLES_MAX || pause_ms < 0 || rapport_ms < 0) {
+        fprintf(stderr, "Usage : %s [-k partitions 1..%d] [-c capacite 1..%lu] [-n cles 0..%d] "
+                "[-p pause_ms] [-i rapport_ms] [-q] [-t]\n", argv[0], PARTITIONS_MAX, CAPACITE_MAX, CLES_MAX);
+        exit(1);
+    }
+
+    struct sigaction psa;
+    psa.sa_handler = handler;
+    sigemptyset(&psa.sa_mask);
+    psa.sa_flags = 0;
+    sigaction(SIGINT, &psa, NULL);
+
+    size_t taille;
+    MemoirePartagee *shm = segment_creer(partitions, capacite, gabarits, &taille);
+    if (shm == NULL) exit(1);
+    partagee = shm;
+
+    Recepteur tube;
+    if (recepteur_ouvrir(&tube, FIFO_PROD) == -1) {
+        perror("Avertissement : Erreur ouverture FIFO");
+    }
+
+    printf("--- Producteur V7 (Partitions) Démarré : %lu partitions de %lu cases de %lu octets%s, %d clé(s) ---\n",
+           partitions, (unsigned long) shm->capacite, (unsigned long) shm->taille_case,
+           gabarits ? " (gabarits)" : "", cles > 0 ? cles : 1);
+
+    char message_actuel[PREFIXE_MAX];
+    snprintf(message_actuel, sizeof(message_actuel), "Defaut");
+    // Mode gabarit : préfixe courant dans la table du segment, et partition de
+    // chaque clé (recalculées seulement quand le préfixe change).
+    static uint64_t partition_cle[CLES_MAX];
+    int prefixe = 0;
+    if (gabarits) {
+        prefixe = prefixe_interner(shm, message_actuel);
+        for (int c = 0; c < (cles > 0 ? cles : 1); c++)
+            partition_cle[c] = partition_de_gabarit(message_actuel, cles > 0 ? c : -1, shm->partitions);
+    }
+    static long compteur[CLES_MAX];             // Compteur PAR CLÉ : "<clé>-<n>" se suit pour chaque clé
+    unsigned long queue_connue[PARTITIONS_MAX] = { 0 };
+    long k = 0;
+
+    Releve avant, apres;
+    relever(shm, &avant);
+    Releve debut = avant;
+    uint64_t prochain_rapport = avant.t + (uint64_t) rapport_ms * 1000000ULL;
+    uint64_t prochain_tube = 0;
+    uint64_t reprise = 0;
+
+    while (!stop) {
+        uint64_t maintenant = horloge_ns();
+
+        // A. COMMANDES (nouvelle clé, ou "stop")
+        if (pause_ms > 0 || maintenant >= prochain_tube) {
+            prochain_tube = maintenant + PERIODE_TUBE_NS;
+            char buffer_cmd[CONTROLE_MAX];
+            while (recepteur_lire(&tube, buffer_cmd, sizeof(buffer_cmd))) {
+                printf("\n[COMMANDE REÇUE] : '%s'\n", buffer_cmd);
+                if (strcmp(buffer_cmd, "stop") == 0) {
+                    printf("Ordre d'arrêt reçu.\n");
+                    stop = 1;
+                    break;
+                }
+                // Le '-' sépare la clé du compteur : on n'en veut pas dans la clé.
+                for (char *c = buffer_cmd; *c; c++) if (*c == '-') *c = '_';
+                // Trop long pour une case avec sa clé et son compteur : on coupe ici,
+                // une fois, plutôt que de laisser snprintf couper le compteur.
+                if (strlen(buffer_cmd) >= PREFIXE_MAX) {
+                    buffer_cmd[PREFIXE_MAX - 1] = '\0';
+                    printf("Préfixe tronqué à %d octets : '%s'\n", PREFIXE_MAX - 1, buffer_cmd);
+                }
+                if (gabarits) {
+                    int id = prefixe_interner(shm, buffer_cmd);
+                    if (id == -1) {
+                        printf("Table des préfixes pleine (%d) : on garde '%s'.\n", PREFIXES_MAX, message_actuel);
+                        continue;
+                    }
+                    prefixe = id;
+                    for (int c = 0; c < (cles > 0 ? cles : 1); c++)
+                        partition_cle[c] = partition_de_gabarit(buffer_cmd, cles > 0 ? c : -1, shm->partitions);
+                }
+                snprintf(message_actuel, sizeof(message_actuel), "%.*s", PREFIXE_MAX - 1, buffer_cmd);
+                memset(compteur, 0, sizeof(compteur));
+            }
+            if (stop) break;
+        }
+
+        // B. RAPPORT PÉRIODIQUE
+        if (rapport_ms > 0 && maintenant >= prochain_rapport) {
+            relever(shm, &apres);
+            rapport(shm, &avant, &apres);
+            avant = apres;
+            prochain_rapport = maintenant + (uint64_t) rapport_ms * 1000000ULL;
+        }
+
+        // C. PAUSE DE DÉMONSTRATION (une commande sur le tube l'écourte)
+        if (maintenant < reprise) {
+            uint64_t limite = reprise;
+            if (rapport_ms > 0 && prochain_rapport < limite) limite = prochain_rapport;
+            struct pollfd pfd = { tube.fd, POLLIN, 0 };
+            poll(&pfd, tube.fd != -1 ? 1 : 0, (int) ((limite - maintenant + 999999) / 1000000));
+            continue;
+        }
+
+        // D. ROUTAGE : la clé choisit la partition
+        int c = cles > 0 ? (int) (k % cles) : 0;
+        char texte[TAILLE_CASE];
+        uint64_t part;
+        if (gabarits) {
+            // Trois entiers dans la case : ni snprintf, ni hachage par message.
+            part = partition_cle[c];
+            Gabarit *g = (Gabarit *) partition_reserver(shm, part, &queue_connue[part], &stop);
+            if (g == NULL) {
+                if (errno == ETIMEDOUT) continue;   // Partition bloquée : tube et rapport, puis on réessaie
+                break;
+            }
+            g->prefixe = (uint32_t) prefixe;
+            g->cle = cles > 0 ? c : -1;
+            g->compteur = compteur[c];
+            if (!silencieux) gabarit_rendre(shm, g, texte, sizeof(texte));
+            partition_publier(shm, part);
+        } else {
+            if (cles > 0) snprintf(texte, sizeof(texte), "%.*s%d-%ld", PREFIXE_MAX - 1, message_actuel, c, compteur[c]);
+            else snprintf(texte, sizeof(texte), "%.*s-%ld", PREFIXE_MAX - 1, message_actuel, compteur[c]);
+            part = partition_de(texte, shm->partitions);
+            if (partition_deposer(shm, part, texte, &queue_connue[part], &stop) == -1) {
+                if (errno == ETIMEDOUT) continue;
+                break;
+            }
+        }
+        compteur[c]++;
+        k++;
+        if (!silencieux) printf("-> Prod : Ecrit '%s' (partition %llu)\n", texte, (unsigned long long) part);
+        if (pause_ms > 0) reprise = horloge_ns() + (uint64_t) pause_ms * 1000000ULL;
+    }
+
+    // Bilan depuis le lancement, puis fin : les consommateurs vident leur partition et s'arrêtent.
+    relever(shm, &apres);
+    printf("\n[Producteur] Fin. %ld message(s).\n", k);
+    rapport(shm, &debut, &apres);
+
+    atomic_store(&shm->fin, 1);
+    for (uint64_t p = 0; p < shm->partitions; p++) parking_secouer(&shm->p[p].parking_conso, 0);
+    partagee = NULL;
+    munmap(shm, taille);
+    shm_unlink(SHM_NAME);
+    recepteur_fermer(&tube, FIFO_PROD);
+
+    return 0;
+}
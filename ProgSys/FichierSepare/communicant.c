@@ -3,57 +3,113 @@
 #include <unistd.h>     // Pour write, close
 #include <string.h>     // Pour strlen, strcmp
 #include <fcntl.h>      // Pour open, O_WRONLY
-#include "common.h"   // Pour récupérer les noms FIFO_PROD et FIFO_CONSO
+#include <signal.h>     // Pour ignorer SIGPIPE
+#include <getopt.h>     // Lecture des options -a -t
+#include "4-common.h" // Noms FIFO_PROD / FIFO_CONSO et boîtes aux lettres du segment V4
 
 #define CMD_SIZE 128
 
-// Fonction utilitaire pour envoyer un message dans un tube nommé
-void envoyer(const char* chemin_fifo, const char* message) {
-    // 1. OUVERTURE DU TUBE (Appel Système open)
-    // O_WRONLY : On ouvre le fichier tube en écriture seule.
-    //
-    // NOTE TECHNIQUE CRITIQUE :
-    // Par défaut, open() sur un FIFO est BLOQUANT si personne n'a ouvert
-    // le tube en lecture de l'autre côté.
-    // Si le Producteur ou le Consommateur n'est pas lancé, le communicant
-    // restera bloqué ici indéfiniment (sauf si on ajoutait O_NONBLOCK).
-    int fd = open(chemin_fifo, O_WRONLY); // open
-    
-    if (fd == -1) {
-        printf("   [Erreur] Impossible d'ouvrir %s. Le destinataire est-il lancé ?\n", chemin_fifo);
-        return;
+// --- SESSION PERSISTANTE ---
+// Avant : pour CHAQUE commande, on rattachait le segment (shm_open + mmap) ou on
+// rouvrait le tube, puis on refermait tout. Maintenant le segment et les tubes
+// restent ouverts d'une commande à l'autre : un script de centaines de commandes
+// ne coûte que les écritures elles-mêmes.
+Projection proj;
+MemoirePartagee *segment = NULL;            // NULL : pas (ou plus) de segment V4
+Liaison liaisons[2] = { { FIFO_CONSO, -1 }, { FIFO_PROD, -1 } };   // Indice = 'producteur'
+int ancien = 0;                             // -a : protocole brut des anciennes versions
+int delai_ms = 2000;                        // -t : attente max d'un destinataire
+
+// Renvoie le segment V4 courant (en se rattachant si le producteur a été relancé),
+// ou NULL s'il n'y en a pas.
+MemoirePartagee* session_segment(void) {
+    if (segment != NULL && atomic_load_explicit(&segment->magique, memory_order_acquire) == MAGIQUE_V4)
+        return segment;
+    if (segment != NULL) {
+        // Le producteur a fermé ce segment (segment_fermer) : on lâche l'ancien.
+        segment_detacher(&proj);
+        segment = NULL;
+    }
+    if (segment_existe()) segment = segment_attacher(0, &proj);
+    return segment;
+}
+
+// Envoie une commande au producteur ('producteur' = 1) ou au consommateur.
+// Si un segment V4 existe, on écrit dans sa boîte aux lettres : le destinataire
+// la voit avec un simple chargement mémoire, sans appel système de son côté.
+// Sinon, on passe par le tube (en trames, ou en texte brut avec -a).
+// Renvoie 0, ou -1 si le destinataire n'a pas répondu dans le délai.
+int envoyer(int producteur, const char* message) {
+    const char *qui = producteur ? "Producteur" : "Consommateur";
+
+    if (!ancien && session_segment() != NULL) {
+        if (boite_poster(segment, producteur, message, delai_ms) == 0) return 0;
+        // Boîte jamais relevée : destinataire arrêté sans fermer le segment ?
+        printf("   [Erreur] Le %s n'a pas relevé sa boîte en %d ms.\n", qui, delai_ms);
+        segment_detacher(&proj);
+        segment = NULL;
+        return -1;
     }
 
-    // 2. ÉCRITURE DU MESSAGE (Appel Système write)
-    // On écrit la chaîne de caractères + le caractère nul de fin (\0).
-    // Cela permet au lecteur de recevoir une chaîne C valide directement.
-    write(fd, message, strlen(message) + 1); //renvoie le nombre d'octets écrits
-    
-    printf("   -> Envoyé à %s : '%s'\n", chemin_fifo, message);
-    
-    // 3. FERMETURE DU DESCRIPTEUR
-    // On ferme l'accès au fichier. Cela envoie un EOF (End Of File) au lecteur
-    // si nous étions le seul écrivain, mais ici c'est juste un nettoyage.
-    close(fd);
+    int r = ancien ? controle_envoyer_brut(liaisons[producteur].chemin, message, delai_ms)
+                   : liaison_envoyer(&liaisons[producteur], message, delai_ms);
+    if (r == -1) {
+        printf("   [Erreur] Personne ne lit %s (%d ms). Le %s est-il lancé ?\n",
+               liaisons[producteur].chemin, delai_ms, qui);
+    }
+    return r;
 }
 
-int main() {
+// Usage : ./communicant [-a] [-t delai_ms] [fichier]
+//   fichier : commandes à envoyer d'une traite (une par ligne), au lieu du clavier.
+//             Marche aussi avec une redirection : ./communicant < script
+//   -a : ancien protocole (texte brut, une connexion par commande), en secours pour
+//        un destinataire compilé avant les trames
+//   -t : attente max d'un destinataire, en ms (2000 par défaut)
+int main(int argc, char *argv[]) {
     char buffer[CMD_SIZE];
+    int opt;
+    while ((opt = getopt(argc, argv, "at:")) != -1) {
+        if (opt == 'a') ancien = 1;
+        else if (opt == 't') delai_ms = atoi(optarg);
+        else {
+            fprintf(stderr, "Usage : %s [-a] [-t delai_ms] [fichier]\n", argv[0]);
+            exit(1);
+        }
+    }
+    FILE *entree = stdin;
+    if (optind < argc && (entree = fopen(argv[optind], "r")) == NULL) {
+        perror(argv[optind]);
+        exit(1);
+    }
+    // Pas de clavier : pas de menu ni d'invite, et un seul bilan à la fin.
+    int interactif = isatty(fileno(entree));
+
+    // Un destinataire qui s'arrête ferme le tube : write() renverra EPIPE
+    // (et on se reconnectera) au lieu de tuer le communicant.
+    signal(SIGPIPE, SIG_IGN);
 
-    printf("=== COMMUNICANT (Télécommande) ===\n");
-    printf("  p [msg] : Envoyer un message au Producteur\n");
-    printf("  c [msg] : Envoyer un message au Consommateur\n");
-    printf("  p stop  : Arrêter le Producteur\n");
-    printf("  c stop  : Arrêter le Consommateur\n");
-    printf("  q       : Quitter\n");
-    printf("====================================\n");
+    int envoyees = 0, echecs = 0;
+
+    if (interactif) {
+        printf("=== COMMUNICANT (Télécommande) ===\n");
+        printf("  p [msg] : Envoyer un message au Producteur\n");
+        printf("  c [msg] : Envoyer un message au Consommateur\n");
+        printf("  p stop  : Arrêter le Producteur\n");
+        printf("  c stop  : Arrêter le Consommateur\n");
+        printf("  q       : Quitter\n");
+        printf("====================================\n");
+    }
 
     while (1) {
-        printf("> ");
+        if (interactif) {
+            printf("> ");
+            fflush(stdout);
+        }
         // "%[^\n]" : Lit tout ce qui n'est PAS un retour à la ligne (donc accepte les espaces).
         // "%127[^\n]" : Limite la lecture à 127 caractères pour éviter le débordement (Sécurité).
         
-        int resultat = scanf(" %127[^\n]", buffer);
+        int resultat = fscanf(entree, " %127[^\n]", buffer);
 
         // Si l'utilisateur fait Ctrl+D (EOF) ou s'il y a une erreur
         if (resultat == EOF) break;
@@ -65,17 +121,27 @@ int main() {
         if (strlen(buffer) == 0) continue;
 
         //  On compare les 2 premiers caracteres
-        if (strncmp(buffer, "p ", 2) == 0) {
-            // Envoie au Producteur tout ce qui suit "p "
-            envoyer(FIFO_PROD, buffer + 2); 
-        }
-        else if (strncmp(buffer, "c ", 2) == 0) {
-            // Envoie au Consommateur tout ce qui suit "c "
-            envoyer(FIFO_CONSO, buffer + 2); 
+        if (strncmp(buffer, "p ", 2) == 0 || strncmp(buffer, "c ", 2) == 0) {
+            // Envoie au Producteur ('p') ou au Consommateur ('c') tout ce qui suit
+            int producteur = (buffer[0] == 'p');
+            if (envoyer(producteur, buffer + 2) == 0) {
+                envoyees++;
+                if (interactif) printf("   -> Envoyé au %s : '%s'\n",
+                                       producteur ? "Producteur" : "Consommateur", buffer + 2);
+            } else {
+                echecs++;
+            }
         }
         else {
             printf("Commande inconnue. Syntaxe : 'p message' ou 'c message'\n");
         }
     }
-    return 0;
+
+    if (!interactif) printf("%d commande(s) envoyée(s), %d échec(s).\n", envoyees, echecs);
+
+    // Fin de session
+    if (segment != NULL) segment_detacher(&proj);
+    for (int k = 0; k < 2; k++) if (liaisons[k].fd != -1) close(liaisons[k].fd);
+    if (entree != stdin) fclose(entree);
+    return echecs ? 1 : 0;
 }
@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <string.h>
+#include <getopt.h>     // Lecture des options -i -n
+#include "4-common.h"
+
+// =================================================================
+// MONITEUR (lecture seule) : l'état de l'anneau V4 en direct
+// =================================================================
+// S'attache au segment en LECTURE SEULE (PROT_READ) : il ne peut rien casser,
+// ne prend aucun verrou et ne réveille personne. Il relit les compteurs tenus
+// par chaque côté (Statistiques) et affiche, à chaque intervalle :
+//   - débits (messages et octets par seconde) de chaque côté,
+//   - retard = items écrits mais pas encore lus (tete - queue),
+//   - blocages : combien de fois le producteur a trouvé l'anneau plein (il est
+//     freiné par le consommateur) ou le consommateur l'a trouvé vide, et la
+//     part du temps passée bloquée. Un blocage est compté quand il SE TERMINE :
+//     un long blocage à cheval sur deux relevés peut dépasser 100 % dans le second.
+// En mode diffusion, une ligne par lecteur inscrit, avec son propre retard :
+// le plus lent est celui qui freine le producteur.
+// Si le producteur est relancé, le moniteur se rattache au nouveau segment.
+
+volatile sig_atomic_t stop = 0;
+
+void handler(int sig) {
+    stop = 1;
+}
+
+// Copie (ordinaire) des compteurs d'un côté, à un instant donné.
+typedef struct {
+    uint64_t messages, octets, blocages, blocage_ns;
+} Compteurs;
+
+typedef struct {
+    uint64_t t;
+    unsigned long tete, queue;
+    Compteurs prod, conso;
+    int actif[LECTEURS_MAX];        // Diffusion : curseurs relevés
+    unsigned long position[LECTEURS_MAX];
+    Compteurs lecteur[LECTEURS_MAX];
+} Releve;
+
+static void copier_stats(Compteurs *dst, Statistiques *src) {
+    dst->messages = atomic_load_explicit(&src->messages, memory_order_relaxed);
+    dst->octets = atomic_load_explicit(&src->octets, memory_order_relaxed);
+    dst->blocages = atomic_load_explicit(&src->blocages, memory_order_relaxed);
+    dst->blocage_ns = atomic_load_explicit(&src->blocage_ns, memory_order_relaxed);
+}
+
+static void relever(MemoirePartagee *shm, Releve *r) {
+    r->t = horloge_ns();
+    // 'queue' AVANT 'tete' : le retard calculé n'est jamais négatif.
+    r->queue = atomic_load_explicit(&shm->queue, memory_order_acquire);
+    r->tete = atomic_load_explicit(&shm->tete, memory_order_acquire);
+    copier_stats(&r->prod, &shm->stats_prod);
+    copier_stats(&r->conso, &shm->stats_conso);
+    for (int k = 0; k < LECTEURS_MAX; k++) {
+        Curseur *l = &shm->curseurs[k];
+        r->actif[k] = shm->diffusion && atomic_load(&l->etat) == CURSEUR_ACTIF;
+        if (!r->actif[k]) continue;
+        r->position[k] = atomic_load_explicit(&l->position, memory_order_acquire);
+        copier_stats(&r->lecteur[k], &l->stats);
+    }
+}
+
+static void afficher_cote(const char *nom, const Compteurs *avant, const Compteurs *apres,
+                          double secondes, const char *blocage) {
+    printf("  %-13s %12.0f msg/s %10.3f Mo/s   %s : %8.0f/s  %5.1f %% du temps   (total %llu msg)\n",
+           nom,
+           (apres->messages - avant->messages) / secondes,
+           (apres->octets - avant->octets) / secondes / 1e6,
+           blocage,
+           (apres->blocages - avant->blocages) / secondes,
+           (apres->blocage_ns - avant->blocage_ns) / (secondes * 1e9) * 100.0,
+           (unsigned long long) apres->messages);
+}
+
+// Usage : ./moniteur [-i intervalle_ms] [-n nombre_de_releves]
+//   -i : période de rafraîchissement (1000 ms par défaut)
+//   -n : s'arrête après n relevés (0 = jusqu'à Ctrl+C)
+// Sur un terminal, l'écran est redessiné à chaque relevé (comme top) ;
+// redirigé vers un fichier, les relevés s'ajoutent les uns aux autres.
+int main(int argc, char *argv[]) {
+    int intervalle_ms = 1000;
+    long nombre = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "i:n:")) != -1) {
+        if (opt == 'i') intervalle_ms = atoi(optarg);
+        else if (opt == 'n') nombre = atol(optarg);
+        else {
+            fprintf(stderr, "Usage : %s [-i intervalle_ms] [-n nombre_de_releves]\n", argv[0]);
+            exit(1);
+        }
+    }
+    if (intervalle_ms <= 0) intervalle_ms = 1000;
+
+    struct sigaction psa;
+    psa.sa_handler = handler;
+    sigemptyset(&psa.sa_mask);
+    psa.sa_flags = 0;
+    sigaction(SIGINT, &psa, NULL);
+
+    int ecran = isatty(STDOUT_FILENO);
+    Projection proj;
+    MemoirePartagee *shm = NULL;
+    Releve avant, apres;
+
+    for (long k = 0; !stop && (nombre == 0 || k < nombre); ) {
+        // 1. (Re)connexion : producteur pas encore lancé, ou relancé.
+        if (shm != NULL && atomic_load_explicit(&shm->magique, memory_order_acquire) != MAGIQUE_V4) {
+            segment_detacher(&proj);
+            shm = NULL;
+        }
+        if (shm == NULL) {
+            if (segment_existe()) shm = segment_attacher(MEM_LECTURE, &proj);
+            if (shm == NULL) {
+                if (ecran) printf("\033[H\033[2J");
+                printf("[Moniteur] En attente d'un producteur V4 (%s)...\n", SHM_NAME);
+                fflush(stdout);
+                usleep(intervalle_ms * 1000);
+                continue;
+            }
+            relever(shm, &avant);
+        }
+
+        // 2. Un intervalle, puis on compare les deux photos.
+        usleep(intervalle_ms * 1000);
+        if (stop) break;
+        relever(shm, &apres);
+        double secondes = (apres.t - avant.t) / 1e9;
+        unsigned long retard = apres.tete - apres.queue;
+        unsigned long capacite = shm->capacite;
+
+        if (ecran) printf("\033[H\033[2J");
+        printf("--- Anneau V4 %s : %lu cases de %lu octets --- relevé %ld (%.2f s)\n",
+               SHM_NAME, capacite, (unsigned long) shm->taille_case, ++k, secondes);
+        afficher_cote("Producteur", &avant.prod, &apres.prod, secondes, "plein");
+        if (!shm->diffusion) {
+            afficher_cote("Consommateur", &avant.conso, &apres.conso, secondes, " vide");
+            printf("  Retard        %lu / %lu cases (%.0f %%)%s\n", retard, capacite,
+                   100.0 * retard / capacite,
+                   retard >= capacite ? "   <- PLEIN : le consommateur freine le producteur"
+                   : retard == 0 ? "   (vide : le consommateur attend)" : "");
+        }
+        for (int l = 0; l < LECTEURS_MAX; l++) {
+            // Un lecteur arrivé pendant l'intervalle n'a pas encore de point de départ.
+            if (!apres.actif[l] || !avant.actif[l]) continue;
+            char nom[TAILLE_NOM + 2];
+            snprintf(nom, sizeof(nom), "[%.*s]", TAILLE_NOM - 1, shm->curseurs[l].nom);
+            afficher_cote(nom, &avant.lecteur[l], &apres.lecteur[l], secondes, " vide");
+            unsigned long r = apres.tete - apres.position[l];
+            printf("  %-13s retard %lu / %lu cases%s\n", "", r, capacite,
+                   r >= capacite ? "   <- le plus lent : il freine le producteur" : "");
+        }
+        if (!ecran) printf("\n");
+        fflush(stdout);
+        avant = apres;
+    }
+
+    if (shm != NULL) segment_detacher(&proj);
+    return 0;
+}
@@ -8,6 +8,8 @@
 #include <string.h>
 #include <signal.h> // Pour la gestion des signaux
 #include <errno.h>  // Pour capturer les interruptions (EINTR)
+#include <getopt.h> // Lecture de l'option -m
+#include "../Outils/sonde.h" // Histogrammes de latence (option -m, affichés sur SIGUSR1)
 
 #define N 10 
 #define TAILLE_MSG 64
@@ -30,6 +32,7 @@ void handler_signal(int sig) {
 
 typedef struct {
     char texte[TAILLE_MSG];
+    uint64_t depose_ns; // Heure de la demande de dépôt (mesure du transfert, 0 sinon)
 } Donnee;
 
 
@@ -46,7 +49,21 @@ typedef struct {
 
 
 
-int main() {
+// Usage : ./3-Fork [-m]
+//   -m : mesure chaque attente, chaque détention du verrou et chaque transfert.
+//        "kill -USR1 -<pid du père>" affiche les histogrammes des deux processus,
+//        qui sont aussi affichés à l'arrêt.
+int main(int argc, char *argv[]) {
+    int mesurer = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "m")) != -1) {
+        if (opt == 'm') mesurer = 1;
+        else exit(1);
+    }
+    Sondes sondes; // Copiée par le fork : chaque processus a ses propres histogrammes
+    sondes_init(&sondes, "Père", mesurer);
+    sonde_installer();
+
     // === 1. CONFIGURATION DU SIGNAL (Slide 127) ===
     // On prépare la structure pour dire au système : 
     // "Si tu reçois SIGINT (Ctrl+C), lance la fonction 'handler_signal'"
@@ -80,11 +97,14 @@ int main() {
 
     // --- CODE DU FILS (CONSOMMATEUR) ---
     if (pid == 0) {
+        sondes.qui = "Fils";
         while (stop==0) { 
             Donnee item_recu;
+            sonde_verifier(&sondes);
             
             // On attend qu'il y ait un item (P sur items_existants)
             // Si on fait Ctrl+C pendant l'attente, sem_wait renvoie -1
+            uint64_t t0 = sonde_debut(&sondes);
             if (sem_wait(&partage->items_existants) == -1) {
                 // On vérifie si c'est à cause du signal
                 if (errno == EINTR) { //Si errno vaut EINTR , cela signifie:"Je n'ai pas eu de problème technique, j'ai été interrompu par un signal (comme Ctrl+C)."
@@ -93,11 +113,14 @@ int main() {
                 }
             }
 
+            sonde_fin(&sondes, SONDE_ATTENTE, t0);
+
             // Si on a reçu le signal stop juste après le wait, on sort
             if (stop) break;
 
             // -- DÉBUT SECTION CRITIQUE --
             sem_wait(&partage->mutex); // Je verrouille l'accès aux index
+            uint64_t t1 = sonde_debut(&sondes);
 
             // Je copie la donnée depuis la mémoire partagée
             item_recu = partage->tab[partage->j];
@@ -105,8 +128,10 @@ int main() {
             // J'avance mon index de lecture (circulaire)
             partage->j = (partage->j + 1) % N;
 
+            sonde_fin(&sondes, SONDE_VERROU, t1);
             sem_post(&partage->mutex); // Je déverrouille
             // -- FIN SECTION CRITIQUE --
+            if (item_recu.depose_ns != 0) sonde_fin(&sondes, SONDE_TRANSFERT, item_recu.depose_ns);
 
             // Je signale qu'une place s'est libérée (V sur places_libres)
             sem_post(&partage->places_libres);
@@ -119,6 +144,7 @@ int main() {
         
         // Si on sort du while, c'est qu'on a fait Ctrl+C
         printf("\n -> [Fils] J'ai reçu l'ordre d'arrêt. Je termine.\n");
+        if (mesurer) sonde_afficher(&sondes);
         exit(0); 
     } 
     
@@ -127,18 +153,25 @@ int main() {
         int k = 0;
         while (stop==0) {
             Donnee item_a_envoyer;
-            // Je prépare mon message dans ma variable locale
-            snprintf(item_a_envoyer.texte, TAILLE_MSG, "Message n°%d", k++);
+            sonde_verifier(&sondes);
             
             // J'attends une place libre. Gestion du Ctrl+C ici aussi.
+            uint64_t t0 = sonde_debut(&sondes);
             if (sem_wait(&partage->places_libres) == -1) {
                 if (errno == EINTR) continue; // Interruption signal -> on re-test le while
             }
+            sonde_fin(&sondes, SONDE_ATTENTE, t0);
 
             if (stop) break;
 
+            // Je prépare mon message dans ma variable locale, une fois la place
+            // obtenue : un signal (SIGUSR1) pendant l'attente ne saute aucun numéro.
+            snprintf(item_a_envoyer.texte, TAILLE_MSG, "Message n°%d", k++);
+            item_a_envoyer.depose_ns = t0;
+
             // -- DÉBUT SECTION CRITIQUE --
             sem_wait(&partage->mutex); // Verrouillage
+            uint64_t t1 = sonde_debut(&sondes);
 
             // Copie de ma structure locale vers la mémoire partagée
             partage->tab[partage->i] = item_a_envoyer;
@@ -146,6 +179,7 @@ int main() {
             // Avance l'index écriture
             partage->i = (partage->i + 1) % N;
 
+            sonde_fin(&sondes, SONDE_VERROU, t1);
             sem_post(&partage->mutex); // Déverrouillage
             // -- FIN SECTION CRITIQUE --
 
@@ -159,6 +193,7 @@ int main() {
         // Gestion de la fin propre
         printf("\n -> [Père] Arrêt demandé. J'attends que mon fils finisse.\n");
         wait(NULL); // J'attends que le fils soit vraiment parti
+        if (mesurer) sonde_afficher(&sondes);
         
         // --- NETTOYAGE (Slide 127) ---
         printf("[Père] Destruction des sémaphores et mémoire.\n");
@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <string.h>
+#include <signal.h> // Pour la gestion des signaux
+#include <getopt.h> // Lecture des options -H -P -L -C -A -S -N -W
+#include "../Outils/memoire.h" // Pages énormes, pré-chargement, mlock
+#include "../Outils/placement.h" // Épinglage père/fils, mémoire sur le nœud du fils
+#include "../Outils/attente.h" // Stratégie d'attente de chaque côté (option -W)
+
+// VERSION 4 : Le tampon est plus grand pour pouvoir contenir des lots entiers.
+#define N 64
+#define TAILLE_MSG 64
+#define TAILLE_LOT_MAX 32   // Taille maximale d'un lot (et valeur par défaut)
+
+// --- STRUCTURE DONNÉES ---
+typedef struct {
+    char texte[TAILLE_MSG];
+} Donnee;
+
+
+// --- MÉMOIRE PARTAGÉE ---
+// Plus de sémaphores : deux compteurs qui ne font qu'avancer ('produits' écrit
+// par le père seul, 'consommes' par le fils seul) et un parking (futex) par côté.
+// Places occupées = produits - consommes. Un seul écrivain par compteur : pas
+// besoin de mutex pour 'i' et 'j' non plus.
+typedef struct {
+    Donnee tab[N];
+    int i;      // Père seulement
+    int j;      // Fils seulement
+    _Atomic unsigned long produits;
+    _Atomic unsigned long consommes;
+    Parking parking_pere;       // Le père dort ici si le tampon est plein
+    Parking parking_fils;       // Le fils dort ici s'il est vide
+} MemoirePartagee;
+
+
+// --- GLOBAL ---
+volatile sig_atomic_t stop = 0;
+MemoirePartagee *partagee = NULL;
+
+void handler_signal(int sig) {
+    stop = 1;
+    // Un côté endormi sur son parking doit se réveiller pour voir 'stop'.
+    if (partagee != NULL) {
+        parking_secouer(&partagee->parking_pere, 0);
+        parking_secouer(&partagee->parking_fils, 0);
+    }
+}
+
+
+// =================================================================
+// OPÉRATIONS PAR LOTS
+// =================================================================
+// Idée : au lieu de payer "P(places) + P(mutex) + V(mutex) + V(items)" pour
+// CHAQUE message, on paie UNE attente et UNE publication par lot : le lot
+// devient visible d'un coup (une seule écriture du compteur) et l'autre côté
+// n'est réveillé qu'UNE fois, et seulement s'il dort. Avec des sémaphores, il
+// fallait un sem_post par message, donc un réveil (appel système) par message
+// quand l'autre côté dormait.
+
+// Réserve entre 1 et 'max' places libres : attend (stratégie 'a') qu'il y en
+// ait au moins une, puis prend toutes celles qui sont libres.
+// Renvoie le nombre de places réservées, ou -1 si '*stop' a été levé.
+int reserver_places(MemoirePartagee *partage, int max, Attente *a) {
+    unsigned long produits = atomic_load_explicit(&partage->produits, memory_order_relaxed);
+    unsigned long consommes = atomic_load_explicit(&partage->consommes, memory_order_acquire);
+    while (produits - consommes == N) {
+        if (stop) return -1;
+        attente_index(a, &partage->parking_pere, &partage->consommes, consommes, &stop, 0);
+        consommes = atomic_load_explicit(&partage->consommes, memory_order_acquire);
+    }
+    unsigned long libres = N - (produits - consommes);
+    return libres < (unsigned long) max ? (int) libres : max;
+}
+
+// Publie les 'n' messages de 'lot' dans des places déjà réservées.
+void publier_lot(MemoirePartagee *partage, const Donnee *lot, int n) {
+    for (int m = 0; m < n; m++) {
+        partage->tab[partage->i] = lot[m];
+        partage->i = (partage->i + 1) % N;
+    }
+    // Les n items deviennent visibles d'un coup pour le fils (release : les
+    // cases sont écrites AVANT que le compteur ne bouge), un seul réveil.
+    atomic_store_explicit(&partage->produits,
+                          atomic_load_explicit(&partage->produits, memory_order_relaxed) + n,
+                          memory_order_release);
+    parking_reveiller(&partage->parking_fils, 0);
+}
+
+// Vide le tampon : attend au moins un item, puis récupère TOUS ceux
+// disponibles (dans la limite de 'max').
+// Renvoie le nombre d'items copiés dans 'lot', ou -1 si '*stop' a été levé.
+int retirer_tout(MemoirePartagee *partage, Donnee *lot, int max, Attente *a) {
+    unsigned long consommes = atomic_load_explicit(&partage->consommes, memory_order_relaxed);
+    unsigned long produits = atomic_load_explicit(&partage->produits, memory_order_acquire);
+    while (produits == consommes) {
+        if (stop) return -1;
+        attente_index(a, &partage->parking_fils, &partage->produits, produits, &stop, 0);
+        produits = atomic_load_explicit(&partage->produits, memory_order_acquire);
+    }
+    int n = (produits - consommes) < (unsigned long) max ? (int) (produits - consommes) : max;
+    for (int m = 0; m < n; m++) {
+        lot[m] = partage->tab[partage->j];
+        partage->j = (partage->j + 1) % N;
+    }
+    // Les n places sont rendues d'un coup au père, un seul réveil.
+    atomic_store_explicit(&partage->consommes, consommes + n, memory_order_release);
+    parking_reveiller(&partage->parking_pere, 0);
+    return n;
+}
+
+
+// Usage : ./4-Fork [-H] [-P] [-L] [-C cpu_pere,cpu_fils | -A | -S] [-N] [-W pere,fils] [taille_lot]   (1 à TAILLE_LOT_MAX, 32 par défaut)
+// Avec taille_lot = 1, on retrouve le rythme de la V3 : une synchronisation par message.
+//   -H : pages énormes   -P : pré-chargement (MAP_POPULATE)   -L : verrouillage (mlock)
+//   -C : épingle le père (producteur) et le fils (consommateur) sur ces CPU
+//   -A : deux cœurs partageant un cache (L2, sinon L3) d'après /sys
+//   -S : sonde ping-pong entre les CPU, la paire la plus rapide est gardée
+//   -N : mémoire partagée sur le nœud NUMA du fils
+//   -W : stratégie d'attente de chaque côté (bloque, spin, cede, adapte ; "bloque" par défaut)
+int main(int argc, char *argv[]) {
+    int options = 0;
+    Placement placement;
+    placement_init(&placement);
+    int strategie_pere = ATTENTE_BLOQUE, strategie_fils = ATTENTE_BLOQUE;
+    int opt;
+    while ((opt = getopt(argc, argv, "HPLC:ASNW:")) != -1) {
+        if (opt == 'H') options |= MEM_HUGE;
+        else if (opt == 'P') options |= MEM_PREFAULT;
+        else if (opt == 'L') options |= MEM_VERROU;
+        else if (opt == 'C') { if (placement_lire(&placement, optarg) == -1) exit(1); }
+        else if (opt == 'A') placement.mode = PLACEMENT_AUTO;
+        else if (opt == 'S') placement.mode = PLACEMENT_SONDE;
+        else if (opt == 'N') placement.numa = 1;
+        else if (opt == 'W') { if (attente_lire_paire(optarg, &strategie_pere, &strategie_fils) == -1) exit(1); }
+        else exit(1);
+    }
+    int taille_lot = (optind < argc) ? atoi(argv[optind]) : TAILLE_LOT_MAX;
+    if (taille_lot < 1 || taille_lot > TAILLE_LOT_MAX) {
+        fprintf(stderr, "Usage : %s [-H] [-P] [-L] [-C p,c | -A | -S] [-N] [-W p,c] [taille_lot] (1 à %d)\n",
+                argv[0], TAILLE_LOT_MAX);
+        exit(1);
+    }
+
+    // === 1. CONFIGURATION DU SIGNAL ===
+    struct sigaction sa;
+    sa.sa_handler = handler_signal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGINT, &sa, NULL);
+
+    // === 2. CRÉATION MÉMOIRE PARTAGÉE ===
+    // Toujours MAP_SHARED | MAP_ANONYMOUS, avec en plus les options demandées.
+    Projection proj;
+    if (projeter_anonyme(&proj, sizeof(MemoirePartagee), options) == -1) exit(1);
+    MemoirePartagee* partage = proj.adresse;
+
+    // === 3. INITIALISATION DES COMPTEURS ===
+    // La projection anonyme est déjà à zéro : tampon vide, personne ne dort.
+    partage->i = 0;
+    partage->j = 0;
+    atomic_store(&partage->produits, 0);
+    atomic_store(&partage->consommes, 0);
+    partagee = partage;
+
+    printf("--- Démarrage (Version Fork V4 - Lots de %d) ---\n", taille_lot);
+    projection_rapport(&proj, "Père", options);
+    placement_preparer(&placement);
+    // Avant le fork : le fils hérite de la politique mémoire de la projection.
+    placement_lier_memoire(&placement, proj.adresse, proj.taille);
+
+    // === 4. DUPLICATION DU PROCESSUS ===
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("Erreur fork");
+        exit(1);
+    }
+
+    // --- CODE DU FILS (CONSOMMATEUR) ---
+    if (pid == 0) {
+        placement_epingler(placement.conso, "Fils");
+        Attente attente;
+        attente_init(&attente, strategie_fils);
+        while (stop == 0) {
+            Donnee lot[TAILLE_LOT_MAX];
+
+            // On récupère tout ce qui est disponible d'un coup.
+            int n = retirer_tout(partage, lot, taille_lot, &attente);
+            if (n <= 0) continue;   // Arrêt demandé -> on re-teste le while
+            if (stop) break;
+
+            // Traitement HORS section critique
+            for (int m = 0; m < n; m++) {
+                printf("   [Fils] J'ai lu : '%s'\n", lot[m].texte);
+            }
+            printf("   [Fils] (lot de %d)\n", n);
+
+            sleep(1);
+        }
+
+        printf("\n -> [Fils] J'ai reçu l'ordre d'arrêt. Je termine.\n");
+        attente_rapport(&attente, "Fils");
+        exit(0);
+    }
+
+    // --- CODE DU PÈRE (PRODUCTEUR) ---
+    else {
+        placement_epingler(placement.prod, "Père");
+        Attente attente;
+        attente_init(&attente, strategie_pere);
+        int k = 0;
+        while (stop == 0) {
+            // 1. Réservation de jusqu'à 'taille_lot' places en une fois
+            int n = reserver_places(partage, taille_lot, &attente);
+            if (n <= 0) continue;
+            if (stop) break;
+
+            // 2. Préparation du lot dans une variable locale (hors verrou)
+            Donnee lot[TAILLE_LOT_MAX];
+            for (int m = 0; m < n; m++) {
+                snprintf(lot[m].texte, TAILLE_MSG, "Message n°%d", k++);
+            }
+
+            // 3. Publication de tout le lot
+            publier_lot(partage, lot, n);
+
+            printf("[Père] J'ai écrit un lot de %d (jusqu'à '%s')\n", n, lot[n - 1].texte);
+            sleep(1);
+        }
+
+        printf("\n -> [Père] Arrêt demandé. J'attends que mon fils finisse.\n");
+        wait(NULL);
+        attente_rapport(&attente, "Père");
+
+        printf("[Père] Libération de la mémoire.\n");
+        partagee = NULL;
+        projection_liberer(&proj);
+
+        printf("[Père] Fin du programme.\n");
+    }
+    return 0;
+}
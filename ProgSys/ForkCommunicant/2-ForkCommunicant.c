@@ -8,6 +8,10 @@
 #include <string.h>     
 #include <sys/stat.h>   // Pour mkfifo
 #include <errno.h>      // Pour gérer les erreurs 
+#include <getopt.h>     // Lecture des options -C -A -S -N -W
+#include "../Outils/placement.h" // Épinglage père/fils, mémoire sur le nœud du fils
+#include "../Outils/attente.h" // Stratégie d'attente de chaque côté (option -W)
+#include "../Outils/controle.h" // Commandes du communicant en trames
 
 // --- CONSTANTES ---
 #define N 10            
@@ -17,6 +21,9 @@
 #define FIFO_P "/tmp/fifo_producteur"
 #define FIFO_C "/tmp/fifo_consommateur"
 
+// Un côté qui attend le tampon relit son tube au moins tous les 100 ms.
+#define PERIODE_TUBE_NS 100000000ULL
+
 typedef struct {
     char texte[TAILLE_MSG];
 } Donnee;
@@ -30,8 +37,28 @@ typedef struct {
     sem_t mutex;
 } Memoire_partagee;
 
-int main() {
+// Usage : ./2-ForkCommunicant [-C cpu_pere,cpu_fils | -A | -S] [-N] [-W pere,fils]
+//   -C : épingle le père (producteur) et le fils (consommateur) sur ces CPU
+//   -A : deux cœurs partageant un cache (L2, sinon L3) d'après /sys
+//   -S : sonde ping-pong entre les CPU, la paire la plus rapide est gardée
+//   -N : mémoire partagée sur le nœud NUMA du fils
+//   -W : stratégie d'attente de chaque côté (bloque, spin, cede, adapte ; "bloque" par défaut)
+int main(int argc, char *argv[]) {
+    Placement placement;
+    placement_init(&placement);
+    int strategie_pere = ATTENTE_BLOQUE, strategie_fils = ATTENTE_BLOQUE;
+    int opt;
+    while ((opt = getopt(argc, argv, "C:ASNW:")) != -1) {
+        if (opt == 'C') { if (placement_lire(&placement, optarg) == -1) exit(1); }
+        else if (opt == 'A') placement.mode = PLACEMENT_AUTO;
+        else if (opt == 'S') placement.mode = PLACEMENT_SONDE;
+        else if (opt == 'N') placement.numa = 1;
+        else if (opt == 'W') { if (attente_lire_paire(optarg, &strategie_pere, &strategie_fils) == -1) exit(1); }
+        else exit(1);
+    }
+
     printf("--- Démarrage (Version Fork V2 + Communicant) ---\n");
+    placement_preparer(&placement);
 
     // Création des tubes nommés
     // On le fait ici pour être sûr qu'ils existent avant que quiconque n'essaie de les ouvrir
@@ -44,6 +71,7 @@ int main() {
                                       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
 
     if (partagee == MAP_FAILED) { perror("mmap"); exit(1); }
+    placement_lier_memoire(&placement, partagee, sizeof(Memoire_partagee));
 
     // 2. INITIALISATION
     partagee->i = 0;
@@ -63,58 +91,60 @@ int main() {
     // 4. CONSOMMATEUR (FILS)
     // =================================================================
     if (pid == 0) {
+        placement_epingler(placement.conso, "Fils");
+        Attente attente;
+        attente_init(&attente, strategie_fils);
         //Avec O_NONBLOCK, open dit : "Oouvre le tube, et si personne 
         //n'écrit dedans pour l'instant, ce n'est pas grave, continue l'exécution tout de suite."
-        int fd_fifo = open(FIFO_C, O_RDONLY | O_NONBLOCK);
+        //(recepteur_ouvrir le fait pour nous, et découpe les trames du communicant)
+        Recepteur tube;
+        recepteur_ouvrir(&tube, FIFO_C);
         
         // On boucle tant que stop est faux (piloté par le communicant)
         while (!stop) { 
             
             // --- A. Écoute du Communicant ---
-            if (fd_fifo != -1) {
-                char buffer[128];
-                int n = read(fd_fifo, buffer, 127); // Lecture non-bloquante
-                //Si il a lu quelquechose
-                if (n > 0) {
-                    //read ne met pas le \0 , il faut le mettre pour strcmp
-                    buffer[n] = '\0';
-
-                    //si les 4 premières lettres sont "stop".
-                    if (strncmp(buffer, "stop", 4) == 0) {
-                        printf("! [Fils] Ordre STOP reçu.\n");
-                        stop = 1; // On sort de la boucle
-                    } 
-                    
-                    else {
-                        printf("! [Fils] Message ADMIN : %s\n", buffer);
-                    }
+            // Lecture non-bloquante : toutes les commandes arrivées, une trame à la fois
+            char buffer[CONTROLE_MAX];
+            while (!stop && recepteur_lire(&tube, buffer, sizeof(buffer))) {
+                //recepteur_lire met le \0 : la commande entière vaut "stop" ?
+                if (strcmp(buffer, "stop") == 0) {
+                    printf("! [Fils] Ordre STOP reçu.\n");
+                    stop = 1; // On sort de la boucle
+                } 
+                
+                else {
+                    printf("! [Fils] Message ADMIN : %s\n", buffer);
                 }
             }
             
-            // --- B. Consommation (Version Non-Bloquante) ---
-            // On utilise sem_trywait au lieu de sem_wait.
-            // Si le tampon est vide, sem_wait bloquerait tout le processus,
-            // et on ne pourrait plus lire le tube pour recevoir l'ordre "stop".
-            if (!stop && sem_trywait(&partagee->items_existants) == 0) {
+            // --- B. Consommation (Attente bornée) ---
+            // Un sem_wait sans limite bloquerait tout le processus, et on ne
+            // pourrait plus lire le tube pour recevoir l'ordre "stop".
+            // On attend donc au plus PERIODE_TUBE_NS, selon la stratégie choisie :
+            // un item qui arrive pendant l'attente est pris TOUT DE SUITE (avant,
+            // sem_trywait puis usleep(100 ms) le faisait attendre jusqu'à 100 ms).
+            if (!stop && attente_sem_delai(&attente, &partagee->items_existants, &stop, PERIODE_TUBE_NS) == 0) {
                 
                 sem_wait(&partagee->mutex); // Accès exclusif
 
-                Donnee item_recu = partagee->tab[partagee->j]; 
-                printf("<- [Fils] Lecture : '%s' (idx %d)\n", item_recu.texte, partagee->j);
+                // Sous le verrou : juste la copie de la case, aucun printf
+                int idx = partagee->j;
+                Donnee item_recu = partagee->tab[idx]; 
                 partagee->j = (partagee->j + 1) % N; 
 
                 sem_post(&partagee->mutex);
                 sem_post(&partagee->places_libres);
 
+                printf("<- [Fils] Lecture : '%s' (idx %d)\n", item_recu.texte, idx);
+
                 sleep(1); 
-            } else {
-                //Pour pas surcharger le CPU (100ms)
-                usleep(100000); 
             }
         }
         
-        // Nettoyage fils
-        if (fd_fifo != -1) close(fd_fifo);
+        attente_rapport(&attente, "Fils");
+        // Nettoyage fils (le père supprime les tubes)
+        if (tube.fd != -1) close(tube.fd);
         exit(0); 
     }
     
@@ -122,8 +152,12 @@ int main() {
     // 5. PRODUCTEUR (PÈRE)
     // =================================================================
     else {
+        placement_epingler(placement.prod, "Père");
+        Attente attente;
+        attente_init(&attente, strategie_pere);
         //Ouverture du tube producteur
-        int fd_fifo = open(FIFO_P, O_RDONLY | O_NONBLOCK);
+        Recepteur tube;
+        recepteur_ouvrir(&tube, FIFO_P);
         
         char message_actuel[TAILLE_MSG] = "Colis defaut"; // Message par défaut
         int k = 0;
@@ -131,40 +165,39 @@ int main() {
         while (!stop) {
             
             // --- A. Écoute du Communicant ---
-            if (fd_fifo != -1) {
-                char buffer[128];
-                int n = read(fd_fifo, buffer, 127);
-                if (n > 0) {
-                    buffer[n] = '\0';
-                    if (strncmp(buffer, "stop", 4) == 0) {
-                        printf("! [Père] Ordre STOP reçu.\n");
-                        stop = 1; 
-                    } else {
-                        // On change le message produit
-                        printf("! [Père] Changement production -> '%s'\n", buffer);
-                        snprintf(message_actuel, TAILLE_MSG, "%s", buffer);
-                        // ecris dans message actuel: buffer, sans depasser la taille du msg
-                    }
+            char buffer[CONTROLE_MAX];
+            while (!stop && recepteur_lire(&tube, buffer, sizeof(buffer))) {
+                if (strcmp(buffer, "stop") == 0) {
+                    printf("! [Père] Ordre STOP reçu.\n");
+                    stop = 1; 
+                } else {
+                    // On change le message produit
+                    printf("! [Père] Changement production -> '%s'\n", buffer);
+                    snprintf(message_actuel, TAILLE_MSG, "%s", buffer);
+                    // ecris dans message actuel: buffer, sans depasser la taille du msg
                 }
             }
 
-            // --- B. Production (Version Non-Bloquante) ---
-            if (!stop && sem_trywait(&partagee->places_libres) == 0) {
+            // --- B. Production (Attente bornée, comme le fils) ---
+            if (!stop && attente_sem_delai(&attente, &partagee->places_libres, &stop, PERIODE_TUBE_NS) == 0) {
                 
+                // On prépare le message actuel (qui a pu être changé par le communicant)
+                // AVANT de prendre le verrou : sous le verrou, juste la copie
+                Donnee item;
+                snprintf(item.texte, TAILLE_MSG, "%s-%d", message_actuel, k++);
+
                 sem_wait(&partagee->mutex);
 
-                // On écrit le message actuel (qui a pu être changé par le communicant)
-                snprintf(partagee->tab[partagee->i].texte, TAILLE_MSG, "%s-%d", message_actuel, k++);
-                
-                printf("-> [Père] Écriture : '%s' (idx %d)\n", partagee->tab[partagee->i].texte, partagee->i);
+                int idx = partagee->i;
+                partagee->tab[idx] = item;
                 partagee->i = (partagee->i + 1) % N;
 
                 sem_post(&partagee->mutex);
                 sem_post(&partagee->items_existants); 
+
+                printf("-> [Père] Écriture : '%s' (idx %d)\n", item.texte, idx);
                 
                 sleep(1);
-            } else {
-                usleep(100000); 
             }
         }
 
@@ -172,12 +205,13 @@ int main() {
         // 6. FIN ET NETTOYAGE
         // =================================================================
         
-        if (fd_fifo != -1) close(fd_fifo);
+        if (tube.fd != -1) close(tube.fd);
         
         // On attend la fin du fils (qui a dû recevoir son propre stop ou qu'on doit tuer)
         // Ici, le communicant envoie stop aux deux manuellement ou on peut tuer le fils :
         kill(pid, SIGTERM); 
         wait(NULL); 
+        attente_rapport(&attente, "Père");
         
         printf("--- Fin du traitement. Nettoyage... ---\n");
 
@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <semaphore.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>   // Pour mkfifo
+#include <errno.h>      // Pour gérer les erreurs
+#include "../Outils/evenement.h" // eventfd + epoll
+#include "../Outils/controle.h"  // Commandes du communicant en trames
+
+// --- CONSTANTES ---
+#define N 10
+#define TAILLE_MSG 64
+
+//Noms des tubes (les mêmes qu'en V2)
+#define FIFO_P "/tmp/fifo_producteur"
+#define FIFO_C "/tmp/fifo_consommateur"
+
+typedef struct {
+    char texte[TAILLE_MSG];
+} Donnee;
+
+// VERSION 3 : les compteurs places/items ne sont plus des sem_t mais des eventfd
+// (hors de la mémoire partagée : ce sont des descripteurs hérités par le fork).
+// Seul le verrou reste un sémaphore.
+typedef struct {
+    Donnee tab[N];
+    int i;
+    int j;
+    sem_t mutex;
+} Memoire_partagee;
+
+// Traite TOUTES les commandes arrivées sur le tube (non bloquant).
+// Il faut tout vider : des trames déjà lues et gardées dans le tampon du
+// récepteur ne réveilleraient plus epoll. Renvoie 1 si l'ordre "stop" est arrivé.
+// 'message' (peut être NULL) reçoit les autres commandes.
+int lire_tube(Recepteur *tube, const char *qui, char *message) {
+    char buffer[CONTROLE_MAX];
+    while (recepteur_lire(tube, buffer, sizeof(buffer))) {
+        if (strcmp(buffer, "stop") == 0) {
+            printf("! [%s] Ordre STOP reçu.\n", qui);
+            return 1;
+        }
+        if (message != NULL) {
+            printf("! [%s] Changement production -> '%s'\n", qui, buffer);
+            snprintf(message, TAILLE_MSG, "%.*s", TAILLE_MSG - 1, buffer);
+        } else {
+            printf("! [%s] Message ADMIN : %s\n", qui, buffer);
+        }
+    }
+    return 0;
+}
+
+int main() {
+    printf("--- Démarrage (Version Fork V3 + Communicant, réveils par événements) ---\n");
+
+    // 1. ALLOCATION MÉMOIRE PARTAGÉE
+    Memoire_partagee* partagee = mmap(NULL, sizeof(Memoire_partagee),
+                                      PROT_READ | PROT_WRITE,
+                                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    if (partagee == MAP_FAILED) { perror("mmap"); exit(1); }
+
+    // 2. INITIALISATION
+    partagee->i = 0;
+    partagee->j = 0;
+    sem_init(&partagee->mutex, 1, 1);
+
+    // Les deux compteurs, créés AVANT le fork pour être partagés.
+    int places_libres = evenement_creer(N);
+    int items_existants = evenement_creer(0);
+    if (places_libres == -1 || items_existants == -1) { perror("eventfd"); exit(1); }
+
+    int stop = 0;
+
+    // 3. FORK
+    pid_t pid = fork();
+    if (pid < 0) { perror("fork"); exit(1); }
+
+    // =================================================================
+    // 4. CONSOMMATEUR (FILS)
+    // =================================================================
+    if (pid == 0) {
+        // Ouvert en O_RDWR (voir recepteur_ouvrir) : sinon, dès que le
+        // communicant referme le tube, epoll signalerait EPOLLHUP en permanence
+        // et on tournerait à vide.
+        Recepteur tube;
+        recepteur_ouvrir(&tube, FIFO_C);
+
+        // UNE seule attente pour les deux sources de réveil :
+        // "il y a un item" OU "le communicant a écrit".
+        int ep = attente_creer(items_existants, tube.fd);
+        if (ep == -1) { perror("epoll"); exit(1); }
+
+        while (!stop) {
+
+            // --- A. Écoute du Communicant ---
+            if (lire_tube(&tube, "Fils", NULL)) {
+                stop = 1;
+                break;
+            }
+
+            // --- B. Consommation ---
+            if (evenement_prendre(items_existants)) {
+
+                sem_wait(&partagee->mutex); // Accès exclusif
+
+                Donnee item_recu = partagee->tab[partagee->j];
+                printf("<- [Fils] Lecture : '%s' (idx %d)\n", item_recu.texte, partagee->j);
+                partagee->j = (partagee->j + 1) % N;
+
+                sem_post(&partagee->mutex);
+                evenement_signaler(places_libres);
+
+                sleep(1);
+            } else {
+                // Plus de usleep(100000) : on dort dans le noyau jusqu'à ce qu'un
+                // item arrive ou que le tube devienne lisible. Réveil en quelques µs.
+                attente_bloquer(ep);
+            }
+        }
+
+        // Nettoyage fils
+        close(ep);
+        recepteur_fermer(&tube, FIFO_C);
+        exit(0);
+    }
+
+    // =================================================================
+    // 5. PRODUCTEUR (PÈRE)
+    // =================================================================
+    else {
+        Recepteur tube;
+        recepteur_ouvrir(&tube, FIFO_P);
+        int ep = attente_creer(places_libres, tube.fd);
+        if (ep == -1) { perror("epoll"); exit(1); }
+
+        char message_actuel[TAILLE_MSG] = "Colis defaut"; // Message par défaut
+        int k = 0;
+
+        while (!stop) {
+
+            // --- A. Écoute du Communicant ---
+            if (lire_tube(&tube, "Père", message_actuel)) {
+                stop = 1;
+                break;
+            }
+
+            // --- B. Production ---
+            if (evenement_prendre(places_libres)) {
+
+                sem_wait(&partagee->mutex);
+
+                snprintf(partagee->tab[partagee->i].texte, TAILLE_MSG, "%s-%d", message_actuel, k++);
+
+                printf("-> [Père] Écriture : '%s' (idx %d)\n", partagee->tab[partagee->i].texte, partagee->i);
+                partagee->i = (partagee->i + 1) % N;
+
+                sem_post(&partagee->mutex);
+                evenement_signaler(items_existants);
+
+                sleep(1);
+            } else {
+                attente_bloquer(ep); // Tampon plein : on attend une place OU une commande
+            }
+        }
+
+        // =================================================================
+        // 6. FIN ET NETTOYAGE
+        // =================================================================
+
+        close(ep);
+        recepteur_fermer(&tube, FIFO_P);
+
+        kill(pid, SIGTERM);
+        wait(NULL);
+
+        printf("--- Fin du traitement. Nettoyage... ---\n");
+
+        sem_destroy(&partagee->mutex);
+        close(places_libres);
+        close(items_existants);
+
+        munmap(partagee, sizeof(Memoire_partagee));
+
+        unlink(FIFO_C); // Le fils a été tué (SIGTERM) avant d'avoir pu le faire
+    }
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/stat.h>   // Pour mkfifo
+#include <errno.h>      // Pour gérer les erreurs
+#include <getopt.h>     // Lecture des options -r -p -q
+#include "../Outils/evenement.h" // Compteurs places/items en eventfd (comme la V3)
+#include "../Outils/controle.h"  // Commandes du communicant en trames
+#include "../Outils/reacteur.h"  // Tâches suspendues sur epoll, un seul thread
+
+// --- CONSTANTES ---
+#define N 10
+#define TAILLE_MSG 64
+#define TAILLE_PREFIXE (TAILLE_MSG - 21)  // Texte produit : laisse la place de "-<k>" (20 chiffres)
+#define ANNEAUX_MAX 256
+
+// Noms des tubes (les mêmes qu'en V2/V3) : se pilote avec le communicant (trames).
+#define FIFO_P "/tmp/fifo_producteur"
+#define FIFO_C "/tmp/fifo_consommateur"
+
+typedef struct {
+    char texte[TAILLE_MSG];
+} Donnee;
+
+// VERSION 4 : PLUSIEURS ANNEAUX, UN SEUL THREAD PAR PROCESSUS.
+// Le père produit dans R anneaux, le fils les consomme tous. Chaque anneau n'a
+// qu'UN écrivain (une tâche du père) et qu'UN lecteur (une tâche du fils) :
+// plus besoin du sémaphore 'mutex' de la V3, les deux eventfd suffisent
+// (read/write sur un eventfd passent par le noyau : la case écrite est
+// visible de l'autre processus avant que le compteur ne bouge).
+typedef struct {
+    Donnee tab[N];
+    int i;      // Écrit par la tâche productrice seulement
+    int j;      // Écrit par la tâche consommatrice seulement
+} Anneau;
+
+// --- ÉTAT D'UN PROCESSUS ---
+// Un seul thread : toutes les tâches d'un processus partagent ces variables
+// sans verrou (une tâche n'est jamais interrompue par une autre entre deux attentes).
+volatile sig_atomic_t stop = 0;
+Anneau *anneaux = NULL;
+int places_libres[ANNEAUX_MAX];     // eventfd : places libres de chaque anneau
+int items_existants[ANNEAUX_MAX];   // eventfd : messages prêts dans chaque anneau
+int nb_anneaux = 4;
+int pause_ms = 1000;
+int silencieux = 0;
+char message_actuel[TAILLE_PREFIXE] = "Colis defaut";
+unsigned long traites = 0;          // Messages produits (père) ou lus (fils)
+
+void handler(int sig) {
+    stop = 1;
+}
+
+// --- CADRES DES TÂCHES ---
+// Tout ce qui doit survivre à une suspension (cf. reacteur.h). 't' en premier.
+typedef struct {
+    Tache t;
+    int anneau;
+    long k;
+} CadreAnneau;
+
+typedef struct {
+    Tache t;
+    Recepteur tube;
+    const char *qui;
+    int producteur;             // 1 : les commandes changent le message produit
+    char commande[CONTROLE_MAX];
+} CadreControle;
+
+// =================================================================
+// TÂCHES
+// =================================================================
+
+// Père : un producteur par anneau. "Attendre une place" suspend la tâche,
+// pas le processus : les autres anneaux et le tube continuent d'avancer.
+int tache_producteur(Reacteur *r, Tache *t) {
+    CadreAnneau *c = (CadreAnneau *) t;
+    Anneau *a = &anneaux[c->anneau];
+    TACHE_DEBUT(t);
+    for (c->k = 0; ; c->k++) {
+        TACHE_ATTENDRE(r, t, places_libres[c->anneau], evenement_prendre(places_libres[c->anneau]));
+
+        snprintf(a->tab[a->i].texte, TAILLE_MSG, "%.*s-%ld", TAILLE_PREFIXE - 1, message_actuel, c->k);
+        if (!silencieux)
+            printf("-> [Père] Anneau %d : '%s' (idx %d)\n", c->anneau, a->tab[a->i].texte, a->i);
+        a->i = (a->i + 1) % N;
+        evenement_signaler(items_existants[c->anneau]);
+        traites++;
+
+        TACHE_DORMIR(r, t, pause_ms);   // Plus de sleep(1) : seule CETTE tâche attend
+    }
+    TACHE_FIN(t);
+}
+
+// Fils : un consommateur par anneau.
+int tache_consommateur(Reacteur *r, Tache *t) {
+    CadreAnneau *c = (CadreAnneau *) t;
+    Anneau *a = &anneaux[c->anneau];
+    TACHE_DEBUT(t);
+    for (;;) {
+        TACHE_ATTENDRE(r, t, items_existants[c->anneau], evenement_prendre(items_existants[c->anneau]));
+
+        if (!silencieux)
+            printf("<- [Fils] Anneau %d : '%s' (idx %d)\n", c->anneau, a->tab[a->j].texte, a->j);
+        a->j = (a->j + 1) % N;
+        evenement_signaler(places_libres[c->anneau]);
+        traites++;
+
+        TACHE_DORMIR(r, t, pause_ms);
+    }
+    TACHE_FIN(t);
+}
+
+// Père et fils : écoute du communicant. Réveillée seulement quand le tube a
+// des données ; lit TOUTES les trames reçues avant de se suspendre à nouveau.
+int tache_controle(Reacteur *r, Tache *t) {
+    CadreControle *c = (CadreControle *) t;
+    TACHE_DEBUT(t);
+    for (;;) {
+        TACHE_ATTENDRE(r, t, c->tube.fd, recepteur_lire(&c->tube, c->commande, sizeof(c->commande)));
+
+        if (strcmp(c->commande, "stop") == 0) {
+            printf("! [%s] Ordre STOP reçu.\n", c->qui);
+            r->arret = 1;
+            break;
+        }
+        if (c->producteur) {
+            // Toutes les tâches productrices verront le nouveau texte à leur prochain message.
+            printf("! [%s] Changement production -> '%s'\n", c->qui, c->commande);
+            snprintf(message_actuel, TAILLE_PREFIXE, "%.*s", TAILLE_PREFIXE - 1, c->commande);
+        } else {
+            printf("! [%s] Message ADMIN : %s\n", c->qui, c->commande);
+        }
+    }
+    TACHE_FIN(t);
+}
+
+// Lance les tâches d'un processus (une par anneau + le contrôle), fait tourner
+// le réacteur jusqu'à l'arrêt, puis affiche le bilan.
+void executer(const char *qui, FonctionTache f, const char *fifo, int producteur, const sigset_t *masque) {
+    Reacteur r;
+    if (reacteur_init(&r) == -1) { perror("epoll"); exit(1); }
+
+    CadreAnneau *cadres = calloc(nb_anneaux, sizeof(CadreAnneau));
+    if (cadres == NULL) { perror("calloc"); exit(1); }
+    for (int a = 0; a < nb_anneaux; a++) {
+        cadres[a].anneau = a;
+        reacteur_lancer(&r, &cadres[a].t, f, qui);
+    }
+
+    // Tâche et tube marqués "rien d'ouvert" : si le tube ne s'ouvre pas, la tâche
+    // n'est jamais lancée et le nettoyage final ne doit rien fermer.
+    CadreControle controle = { .t.minuteur = -1, .tube.fd = -1, .qui = qui, .producteur = producteur };
+    if (recepteur_ouvrir(&controle.tube, fifo) == -1) perror("Avertissement : tube de commandes");
+    else reacteur_lancer(&r, &controle.t, tache_controle, qui);
+
+    reacteur_tourner(&r, &stop, masque);
+
+    uint64_t suspensions = 0;
+    for (int a = 0; a < nb_anneaux; a++) {
+        suspensions += cadres[a].t.suspensions;
+        tache_liberer(&cadres[a].t);
+    }
+    printf("[%s] Bilan : %lu message(s) sur %d anneau(x), %llu réveil(s) epoll, %llu reprise(s), "
+           "%llu suspension(s) (%.2f message(s) par réveil)\n", qui, traites, nb_anneaux,
+           (unsigned long long) r.reveils, (unsigned long long) r.reprises,
+           (unsigned long long) suspensions, r.reveils ? (double) traites / r.reveils : 0.0);
+
+    tache_liberer(&controle.t);
+    recepteur_fermer(&controle.tube, fifo);
+    reacteur_fermer(&r);
+    free(cadres);
+}
+
+// Usage : ./4-ForkCommunicant [-r anneaux] [-p pause_ms] [-q]
+//   -r : nombre d'anneaux (4 par défaut, au plus ANNEAUX_MAX), tous servis par
+//        UN thread dans le père et UN thread dans le fils
+//   -p : pause de chaque tâche après chaque message (1000 ms par défaut, 0 = pleine vitesse)
+//   -q : n'affiche pas chaque message (seulement le bilan)
+int main(int argc, char *argv[]) {
+    int opt;
+    while ((opt = getopt(argc, argv, "r:p:q")) != -1) {
+        if (opt == 'r') nb_anneaux = atoi(optarg);
+        else if (opt == 'p') pause_ms = atoi(optarg);
+        else if (opt == 'q') silencieux = 1;
+        else exit(1);
+    }
+    if (nb_anneaux < 1 || nb_anneaux > ANNEAUX_MAX || pause_ms < 0) {
+        fprintf(stderr, "Usage : %s [-r anneaux 1..%d] [-p pause_ms] [-q]\n", argv[0], ANNEAUX_MAX);
+        exit(1);
+    }
+
+    printf("--- Démarrage (Version Fork V4 + Communicant, %d anneaux sur un réacteur par processus) ---\n",
+           nb_anneaux);
+    fflush(stdout);     // Sinon le fils hérite du tampon et réaffiche ces lignes
+
+    // 1. SIGNAUX : SIGINT n'est délivré QUE pendant epoll_pwait (cf. reacteur_tourner).
+    struct sigaction sa;
+    sa.sa_handler = handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGINT, &sa, NULL);
+    sigset_t signaux, ancien;
+    sigemptyset(&signaux);
+    sigaddset(&signaux, SIGINT);
+    sigprocmask(SIG_BLOCK, &signaux, &ancien);
+
+    // 2. MÉMOIRE PARTAGÉE ET COMPTEURS (créés AVANT le fork pour être partagés)
+    size_t taille = nb_anneaux * sizeof(Anneau);
+    anneaux = mmap(NULL, taille, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (anneaux == MAP_FAILED) { perror("mmap"); exit(1); }
+    for (int a = 0; a < nb_anneaux; a++) {
+        places_libres[a] = evenement_creer(N);
+        items_existants[a] = evenement_creer(0);
+        if (places_libres[a] == -1 || items_existants[a] == -1) { perror("eventfd"); exit(1); }
+    }
+
+    // 3. FORK
+    pid_t pid = fork();
+    if (pid < 0) { perror("fork"); exit(1); }
+
+    // 4. CONSOMMATEUR (FILS)
+    if (pid == 0) {
+        executer("Fils", tache_consommateur, FIFO_C, 0, &ancien);
+        exit(0);
+    }
+
+    // 5. PRODUCTEUR (PÈRE)
+    executer("Père", tache_producteur, FIFO_P, 1, &ancien);
+
+    // 6. FIN ET NETTOYAGE : le fils reçoit un SIGINT pour afficher son bilan lui aussi.
+    kill(pid, SIGINT);
+    wait(NULL);
+    printf("--- Fin du traitement. Nettoyage... ---\n");
+
+    for (int a = 0; a < nb_anneaux; a++) {
+        close(places_libres[a]);
+        close(items_existants[a]);
+    }
+    munmap(anneaux, taille);
+    return 0;
+}
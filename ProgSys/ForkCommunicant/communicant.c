@@ -3,59 +3,86 @@
 #include <unistd.h>     // Pour write, close
 #include <string.h>     // Pour strlen, strcmp
 #include <fcntl.h>      // Pour open, O_WRONLY
+#include <signal.h>     // Pour ignorer SIGPIPE
+#include <getopt.h>     // Lecture des options -a -t
 #include "common.h"   // Pour récupérer les noms FIFO_PROD et FIFO_CONSO
+#include "../Outils/controle.h" // Connexion avec délai + commandes en trames
 
 #define CMD_SIZE 128
 
-// Fonction utilitaire pour envoyer un message dans un tube nommé
-void envoyer(const char* chemin_fifo, const char* message) {
-    // 1. OUVERTURE DU TUBE (Appel Système open)
-    // O_WRONLY : On ouvre le fichier tube en écriture seule.
-    //
-    // NOTE TECHNIQUE CRITIQUE :
-    // Par défaut, open() sur un FIFO est BLOQUANT si personne n'a ouvert
-    // le tube en lecture de l'autre côté.
-    // Si le Producteur ou le Consommateur n'est pas lancé, le communicant
-    // restera bloqué ici indéfiniment (sauf si on ajoutait O_NONBLOCK).
-    int fd = open(chemin_fifo, O_WRONLY); //open connecte le prog à l'entrée du tuyau, (adresse du fichier, mode d'ouverture) , fd: ticket de vestiaire
-    
-    if (fd == -1) {
-        printf("   [Erreur] Impossible d'ouvrir %s. Le destinataire est-il lancé ?\n", chemin_fifo);
-        return;
-    }
+// --- SESSION PERSISTANTE ---
+// Avant : un open/write/close par commande, et un open() BLOQUANT pour toujours
+// si le destinataire n'était pas lancé. Maintenant chaque tube est ouvert une
+// fois (avec un délai max) et reste ouvert ; les commandes partent en trames
+// (voir ../Outils/controle.h).
+Liaison liaisons[2] = { { FIFO_CONSO, -1 }, { FIFO_PROD, -1 } };   // Indice = 1 pour le Producteur
+int ancien = 0;                             // -a : texte brut (anciens destinataires)
+int delai_ms = 2000;                        // -t : attente max d'un destinataire
 
-    // 2. ÉCRITURE DU MESSAGE (Appel Système write)
-    // On écrit la chaîne de caractères + le caractère nul de fin (\0).
-    // Cela permet au lecteur de recevoir une chaîne C valide directement.
-    write(fd, message, strlen(message) + 1); //renvoie le nombre d'octets écrits
-    //où, quoi, combien
-    
-    printf("   -> Envoyé à %s : '%s'\n", chemin_fifo, message);
-    
-    // 3. FERMETURE DU DESCRIPTEUR
-    // On ferme l'accès au fichier. Cela envoie un EOF (End Of File) au lecteur
-    // si nous étions le seul écrivain, mais ici c'est juste un nettoyage.
-    close(fd);
+// Envoie une commande au Producteur ('producteur' = 1) ou au Consommateur.
+// Renvoie 0, ou -1 si personne ne lit le tube dans le délai.
+int envoyer(int producteur, const char* message) {
+    Liaison *l = &liaisons[producteur];
+    int r = ancien ? controle_envoyer_brut(l->chemin, message, delai_ms)
+                   : liaison_envoyer(l, message, delai_ms);
+    if (r == -1) {
+        printf("   [Erreur] Personne ne lit %s (%d ms). Le destinataire est-il lancé ?\n",
+               l->chemin, delai_ms);
+    }
+    return r;
 }
 
-int main() {
+// Usage : ./communicant [-a] [-t delai_ms] [fichier]
+//   fichier : commandes à envoyer d'une traite (une par ligne), au lieu du clavier.
+//             Marche aussi avec une redirection : ./communicant < script
+//   -a : ancien protocole (texte brut, une connexion par commande), en secours pour
+//        un destinataire compilé avant les trames
+//   -t : attente max d'un destinataire, en ms (2000 par défaut)
+int main(int argc, char *argv[]) {
     char buffer[CMD_SIZE];
+    int opt;
+    while ((opt = getopt(argc, argv, "at:")) != -1) {
+        if (opt == 'a') ancien = 1;
+        else if (opt == 't') delai_ms = atoi(optarg);
+        else {
+            fprintf(stderr, "Usage : %s [-a] [-t delai_ms] [fichier]\n", argv[0]);
+            exit(1);
+        }
+    }
+    FILE *entree = stdin;
+    if (optind < argc && (entree = fopen(argv[optind], "r")) == NULL) {
+        perror(argv[optind]);
+        exit(1);
+    }
+    // Pas de clavier : pas de menu ni d'invite, et un seul bilan à la fin.
+    int interactif = isatty(fileno(entree));
+
+    // Un destinataire qui s'arrête ferme le tube : write() renverra EPIPE
+    // (et on se reconnectera) au lieu de tuer le communicant.
+    signal(SIGPIPE, SIG_IGN);
 
-    printf("=== COMMUNICANT (Télécommande) ===\n");
-    printf("  p [msg] : Envoyer un message au Producteur\n");
-    printf("  c [msg] : Envoyer un message au Consommateur\n");
-    printf("  p stop  : Arrêter le Producteur\n");
-    printf("  c stop  : Arrêter le Consommateur\n");
-    printf("  q       : Quitter\n");
-    printf("====================================\n");
+    int envoyees = 0, echecs = 0;
+
+    if (interactif) {
+        printf("=== COMMUNICANT (Télécommande) ===\n");
+        printf("  p [msg] : Envoyer un message au Producteur\n");
+        printf("  c [msg] : Envoyer un message au Consommateur\n");
+        printf("  p stop  : Arrêter le Producteur\n");
+        printf("  c stop  : Arrêter le Consommateur\n");
+        printf("  q       : Quitter\n");
+        printf("====================================\n");
+    }
 
     while (1) {
-        printf("> ");
+        if (interactif) {
+            printf("> ");
+            fflush(stdout);
+        }
         
         // "%[^\n]" : Lit tout ce qui n'est PAS un retour à la ligne (donc accepte les espaces).
         // "%127[^\n]" : Limite la lecture à 127 caractères pour éviter le débordement (Sécurité).
         
-        int resultat = scanf(" %127[^\n]", buffer);
+        int resultat = fscanf(entree, " %127[^\n]", buffer);
 
         // Si l'utilisateur fait Ctrl+D (EOF) ou s'il y a une erreur
         if (resultat == EOF) break;
@@ -67,19 +94,25 @@ int main() {
         if (strlen(buffer) == 0) continue;
 
         //  On compare les 2 premiers caracteres
-        if (strncmp(buffer, "p ", 2) == 0) {
-            // Envoie au Producteur tout ce qui suit "p "
-            envoyer(FIFO_PROD, buffer + 2); 
-        }
-        else if (strncmp(buffer, "c ", 2) == 0) {
-            // Envoie au Consommateur tout ce qui suit "c "
-            envoyer(FIFO_CONSO, buffer + 2); 
+        if (strncmp(buffer, "p ", 2) == 0 || strncmp(buffer, "c ", 2) == 0) {
+            // Envoie au Producteur ('p') ou au Consommateur ('c') tout ce qui suit
+            int producteur = (buffer[0] == 'p');
+            if (envoyer(producteur, buffer + 2) == 0) {
+                envoyees++;
+                if (interactif) printf("   -> Envoyé à %s : '%s'\n", liaisons[producteur].chemin, buffer + 2);
+            } else {
+                echecs++;
+            }
         }
         else {
             printf("Commande inconnue. Syntaxe : 'p message' ou 'c message'\n");
         }
     }
-    return 0;
-}
 
+    if (!interactif) printf("%d commande(s) envoyée(s), %d échec(s).\n", envoyees, echecs);
 
+    // Fin de session
+    for (int k = 0; k < 2; k++) if (liaisons[k].fd != -1) close(liaisons[k].fd);
+    if (entree != stdin) fclose(entree);
+    return echecs ? 1 : 0;
+}
@@ -0,0 +1,223 @@
+#ifndef ATTENTE_H
+#define ATTENTE_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>          // sched_yield
+#include <signal.h>
+#include <semaphore.h>
+#include <time.h>
+#include "futex.h"          // Parking (variante futex des anneaux sans verrou)
+
+// --- STRATÉGIES D'ATTENTE ---
+// Quand le tampon est plein (ou vide), un côté doit attendre. S'endormir tout de
+// suite (sem_wait, futex) coûte deux passages dans le noyau et un réveil par
+// l'ordonnanceur : plusieurs µs, parfois des dizaines. Tourner en boucle coûte
+// un cœur entier, mais l'autre côté est vu en quelques dizaines de ns.
+// Chaque côté choisit (-W) :
+//   bloque : s'endort tout de suite (comportement historique)
+//   spin   : boucle active avec l'instruction 'pause', ne dort JAMAIS
+//            (à réserver à un cœur dédié, cf. -C / -A)
+//   cede   : boucle courte, puis sched_yield en boucle (laisse passer les
+//            autres threads du cœur sans quitter la file d'exécution)
+//   adapte : boucle d'au plus 'budget' tours, puis s'endort ; le budget double
+//            quand la boucle a suffi et diminue de moitié quand il a fallu dormir
+//            (même idée que les mutex adaptatifs de la glibc)
+// Les compteurs disent ce qui s'est VRAIMENT passé : combien d'attentes ont été
+// résolues par la boucle, combien de cessions, combien d'endormissements.
+#define ATTENTE_BLOQUE 0
+#define ATTENTE_SPIN   1
+#define ATTENTE_CEDE   2
+#define ATTENTE_ADAPTE 3
+
+#define ATTENTE_TOURS_CEDE 256      // Tours de boucle avant le premier sched_yield
+#define ATTENTE_BUDGET_MIN 16
+#define ATTENTE_BUDGET_INIT 1024
+#define ATTENTE_BUDGET_MAX 65536
+
+static const char *const noms_attentes[] = { "bloque", "spin", "cede", "adapte" };
+
+typedef struct {
+    int strategie;
+    uint32_t budget;        // Tours de boucle avant de dormir (adapte)
+    uint64_t attentes;      // Appels où la condition n'était PAS déjà remplie
+    uint64_t par_boucle;    // ... résolus pendant la boucle active
+    uint64_t tours;         // Total des tours de boucle
+    uint64_t cessions;      // sched_yield faits
+    uint64_t endormis;      // Endormissements (sem_wait, futex)
+} Attente;
+
+// Indique au processeur qu'on est dans une boucle d'attente : libère des
+// ressources pour l'autre thread matériel du cœur et évite la pénalité de
+// sortie de boucle (mauvaise spéculation sur l'ordre mémoire).
+static inline void attente_pause(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield" ::: "memory");
+#else
+    atomic_signal_fence(memory_order_seq_cst);
+#endif
+}
+
+static inline void attente_init(Attente *a, int strategie) {
+    memset(a, 0, sizeof(*a));
+    a->strategie = strategie;
+    a->budget = ATTENTE_BUDGET_INIT;
+}
+
+// Nom -> ATTENTE_*, ou -1 si inconnu.
+static inline int attente_lire(const char *nom) {
+    for (int k = 0; k < 4; k++) if (strcmp(nom, noms_attentes[k]) == 0) return k;
+    return -1;
+}
+
+// "-W prod,conso" (ou un seul nom pour les deux côtés). Renvoie 0, ou -1 si invalide.
+static inline int attente_lire_paire(const char *texte, int *prod, int *conso) {
+    char copie[64];
+    snprintf(copie, sizeof(copie), "%s", texte);
+    char *virgule = strchr(copie, ',');
+    if (virgule != NULL) *virgule = '\0';
+    *prod = attente_lire(copie);
+    *conso = virgule != NULL ? attente_lire(virgule + 1) : *prod;
+    if (*prod == -1 || *conso == -1) {
+        fprintf(stderr, "Option -W : attendu 'strategie' ou 'prod,conso' parmi bloque, spin, cede, adapte\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Boucle active de 'a' : après 'tours' tours sans succès, où en est-on ?
+// Renvoie 1 s'il faut maintenant dormir (bloque, ou budget d'adapte épuisé).
+static inline int attente_tour(Attente *a, uint32_t tours) {
+    switch (a->strategie) {
+    case ATTENTE_SPIN:
+        attente_pause();
+        return 0;
+    case ATTENTE_CEDE:
+        if (tours < ATTENTE_TOURS_CEDE) attente_pause();
+        else {
+            a->cessions++;
+            sched_yield();
+        }
+        return 0;
+    case ATTENTE_ADAPTE:
+        if (tours >= a->budget) return 1;
+        attente_pause();
+        return 0;
+    default:
+        return 1;
+    }
+}
+
+// Fin d'une attente : compteurs et ajustement du budget d'adapte.
+static inline void attente_bilan(Attente *a, uint32_t tours, int endormi) {
+    a->tours += tours;
+    if (endormi) {
+        a->endormis++;
+        if (a->strategie == ATTENTE_ADAPTE && a->budget > ATTENTE_BUDGET_MIN) a->budget /= 2;
+    } else {
+        a->par_boucle++;
+        if (a->strategie == ATTENTE_ADAPTE && a->budget < ATTENTE_BUDGET_MAX) a->budget *= 2;
+    }
+}
+
+// --- VARIANTE SÉMAPHORE ---
+// Remplace sem_wait(s). Renvoie 0 (jeton pris), ou -1 avec errno = EINTR si un
+// signal a interrompu l'attente ou si '*stop' a été levé pendant la boucle.
+static inline int attente_sem(Attente *a, sem_t *s, const volatile sig_atomic_t *stop) {
+    if (sem_trywait(s) == 0) return 0;
+    a->attentes++;
+    uint32_t tours = 0;
+    for (;;) {
+        if (*stop) {
+            a->tours += tours;
+            errno = EINTR;
+            return -1;
+        }
+        if (attente_tour(a, tours)) break;
+        tours++;
+        if (sem_trywait(s) == 0) {
+            attente_bilan(a, tours, 0);
+            return 0;
+        }
+    }
+    attente_bilan(a, tours, 1);
+    return sem_wait(s);
+}
+
+// Comme attente_sem, mais l'endormissement dure au plus 'delai_ns' (pour un
+// côté qui doit aussi surveiller autre chose, un tube par exemple).
+// Renvoie 0, ou -1 avec errno = ETIMEDOUT / EINTR.
+static inline int attente_sem_delai(Attente *a, sem_t *s, const volatile sig_atomic_t *stop,
+                                    uint64_t delai_ns) {
+    if (sem_trywait(s) == 0) return 0;
+    a->attentes++;
+    struct timespec limite;
+    clock_gettime(CLOCK_REALTIME, &limite);     // sem_timedwait attend une heure absolue
+    uint64_t ns = (uint64_t) limite.tv_nsec + delai_ns;
+    limite.tv_sec += ns / 1000000000ULL;
+    limite.tv_nsec = ns % 1000000000ULL;
+    uint32_t tours = 0;
+    for (;;) {
+        if (*stop) {
+            a->tours += tours;
+            errno = EINTR;
+            return -1;
+        }
+        if (attente_tour(a, tours)) break;
+        tours++;
+        if (sem_trywait(s) == 0) {
+            attente_bilan(a, tours, 0);
+            return 0;
+        }
+        // Les stratégies qui ne dorment jamais doivent quand même rendre la main à temps.
+        if ((tours & 1023) == 0) {
+            struct timespec t;
+            clock_gettime(CLOCK_REALTIME, &t);
+            if (t.tv_sec > limite.tv_sec || (t.tv_sec == limite.tv_sec && t.tv_nsec >= limite.tv_nsec)) {
+                a->tours += tours;
+                errno = ETIMEDOUT;
+                return -1;
+            }
+        }
+    }
+    attente_bilan(a, tours, 1);
+    return sem_timedwait(s, &limite);
+}
+
+// --- VARIANTE FUTEX (anneaux sans verrou) ---
+// Remplace parking_attendre : rend la main quand '*index' ne vaut plus
+// 'ancienne' (ou sur '*stop'). L'appelant relit l'index et reboucle, comme avant.
+static inline void attente_index(Attente *a, Parking *p, _Atomic unsigned long *index, unsigned long ancienne,
+                                 const volatile sig_atomic_t *stop, int prive) {
+    a->attentes++;
+    uint32_t tours = 0;
+    while (!*stop && atomic_load_explicit(index, memory_order_acquire) == ancienne) {
+        if (attente_tour(a, tours)) {
+            // Un endormissement ne compte (et ne réduit le budget adaptatif) que
+            // si le futex a vraiment dormi : sinon l'autre côté avait déjà bougé.
+            attente_bilan(a, tours, parking_attendre(p, index, ancienne, stop, prive));
+            return;
+        }
+        tours++;
+    }
+    attente_bilan(a, tours, 0);
+}
+
+// Une ligne de bilan par côté.
+static inline void attente_rapport(const Attente *a, const char *qui) {
+    printf("[%s] Attente '%s' : %llu attente(s), %llu résolue(s) en boucle (%.0f %%), "
+           "%llu endormissement(s), %llu cession(s), %.0f tours en moyenne",
+           qui, noms_attentes[a->strategie], (unsigned long long) a->attentes,
+           (unsigned long long) a->par_boucle, a->attentes ? 100.0 * a->par_boucle / a->attentes : 0.0,
+           (unsigned long long) a->endormis, (unsigned long long) a->cessions,
+           a->attentes ? (double) a->tours / a->attentes : 0.0);
+    if (a->strategie == ATTENTE_ADAPTE) printf(", budget final %u", a->budget);
+    printf("\n");
+}
+
+#endif
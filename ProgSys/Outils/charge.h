@@ -0,0 +1,151 @@
+#ifndef CHARGE_H
+#define CHARGE_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "histo.h"      // horloge_ns
+
+// =================================================================
+// GÉNÉRATEUR DE CHARGE EN BOUCLE OUVERTE
+// =================================================================
+// En boucle FERMÉE, le producteur envoie le message suivant quand le précédent
+// est parti : si la file cale 10 ms, il cale avec elle et les messages qu'il
+// "aurait dû" envoyer pendant ce temps n'existent jamais. Les latences mesurées
+// paraissent bonnes alors que le service a calé ("omission coordonnée").
+// En boucle OUVERTE, l'heure d'envoi de chaque message est fixée à l'avance par
+// un calendrier. Si on est en retard, on envoie tout de suite SANS sauter de
+// message, et la latence est comptée depuis l'heure PRÉVUE.
+
+// --- PROFILS DE DÉBIT ---
+#define PROFIL_FERME    0   // Boucle fermée : aussi vite que possible
+#define PROFIL_CONSTANT 1   // Un message toutes les 1/débit secondes
+#define PROFIL_POISSON  2   // Arrivées aléatoires (écarts exponentiels), débit moyen donné
+#define PROFIL_RAFALES  3   // Débit constant pendant 'actif', silence pendant 'repos'
+
+// --- LOIS DE TAILLE DES MESSAGES ---
+#define LOI_FIXE     0      // Toujours la taille max
+#define LOI_UNIFORME 1      // Uniforme entre min et max
+#define LOI_EXPO     2      // Exponentielle de moyenne donnée, bornée à [min, max]
+
+typedef struct {
+    int profil;
+    double debit;           // Messages par seconde (pendant les phases actives)
+    uint64_t actif_ns;      // Rafales : durée d'une phase d'émission
+    uint64_t repos_ns;      // Rafales : durée d'une phase de silence
+    int loi;
+    unsigned long taille_min;
+    double taille_moyenne;  // Loi exponentielle
+} Charge;
+
+// --- GÉNÉRATEUR ALÉATOIRE (xorshift64*) ---
+// rand() est partagé par tous les threads (et verrouillé) : chaque producteur a
+// ici son propre état, et un tirage coûte quelques instructions.
+typedef struct {
+    uint64_t etat;
+} Alea;
+
+static inline void alea_init(Alea *a, uint64_t graine) {
+    a->etat = graine * 0x9E3779B97F4A7C15ULL + 1;  // Jamais 0
+}
+
+static inline uint64_t alea_suivant(Alea *a) {
+    a->etat ^= a->etat >> 12;
+    a->etat ^= a->etat << 25;
+    a->etat ^= a->etat >> 27;
+    return a->etat * 0x2545F4914F6CDD1DULL;
+}
+
+// Réel uniforme dans ]0, 1].
+static inline double alea_uniforme(Alea *a) {
+    return ((alea_suivant(a) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+// --- CALENDRIER ---
+// Heure PRÉVUE du message suivant, à partir de celle du message précédent.
+// 'debut' sert de référence pour le cycle actif/repos des rafales.
+static inline uint64_t charge_prochain(const Charge *c, Alea *a, uint64_t precedent, uint64_t debut) {
+    double ecart = 1e9 / c->debit;
+    if (c->profil == PROFIL_POISSON) ecart = -log(alea_uniforme(a)) * ecart;
+    uint64_t t = precedent + (uint64_t) ecart;
+
+    if (c->profil == PROFIL_RAFALES) {
+        // Si on tombe dans une phase de repos, on saute au début de la phase active suivante.
+        uint64_t cycle = c->actif_ns + c->repos_ns;
+        uint64_t dans_cycle = (t - debut) % cycle;
+        if (dans_cycle >= c->actif_ns) t += cycle - dans_cycle;
+    }
+    return t;
+}
+
+// Taille (octets) du prochain message, entre taille_min et 'max'.
+static inline unsigned long charge_taille(const Charge *c, Alea *a, unsigned long max) {
+    unsigned long min = c->taille_min < max ? c->taille_min : max;
+    unsigned long n = max;
+    if (c->loi == LOI_UNIFORME) {
+        n = min + alea_suivant(a) % (max - min + 1);
+    } else if (c->loi == LOI_EXPO) {
+        double x = -log(alea_uniforme(a)) * c->taille_moyenne;
+        n = (x >= (double) max) ? max : (unsigned long) x;
+        if (n < min) n = min;
+    }
+    return n;
+}
+
+// Attend l'heure 't' (horloge_ns). Le sommeil du noyau est imprécis (50 µs et
+// plus) : on dort jusqu'à un peu avant, puis on scrute l'horloge.
+#define MARGE_SOMMEIL_NS 60000
+static inline void attendre_heure(uint64_t t) {
+    uint64_t maintenant = horloge_ns();
+    if (t > maintenant + MARGE_SOMMEIL_NS) {
+        uint64_t d = t - maintenant - MARGE_SOMMEIL_NS;
+        struct timespec ts = { (time_t) (d / 1000000000ULL), (long) (d % 1000000000ULL) };
+        nanosleep(&ts, NULL);
+    }
+    while (horloge_ns() < t) {}
+}
+
+// Temps de service simulé côté consommateur : on OCCUPE le processeur
+// (un sleep libérerait le cœur, ce que ne fait pas un vrai traitement).
+static inline void travail_simule(uint64_t ns) {
+    if (ns == 0) return;
+    uint64_t fin = horloge_ns() + ns;
+    while (horloge_ns() < fin) {}
+}
+
+// --- LECTURE DES OPTIONS ---
+// Profil : "ferme", "constant:DEBIT", "poisson:DEBIT", "rafales:DEBIT:ACTIF_MS:REPOS_MS"
+// Renvoie 0, ou -1 si le texte est invalide.
+static inline int charge_lire_profil(Charge *c, const char *texte) {
+    double actif_ms = 0, repos_ms = 0;
+    if (strcmp(texte, "ferme") == 0) {
+        c->profil = PROFIL_FERME;
+        return 0;
+    }
+    if (sscanf(texte, "constant:%lf", &c->debit) == 1) c->profil = PROFIL_CONSTANT;
+    else if (sscanf(texte, "poisson:%lf", &c->debit) == 1) c->profil = PROFIL_POISSON;
+    else if (sscanf(texte, "rafales:%lf:%lf:%lf", &c->debit, &actif_ms, &repos_ms) == 3
+             && actif_ms > 0 && repos_ms >= 0) {
+        c->profil = PROFIL_RAFALES;
+        c->actif_ns = (uint64_t) (actif_ms * 1e6);
+        c->repos_ns = (uint64_t) (repos_ms * 1e6);
+    } else return -1;
+    return c->debit > 0 ? 0 : -1;
+}
+
+// Loi de taille : "fixe", "uniforme:MIN", "expo:MOYENNE[:MIN]" (le max est la taille de case).
+static inline int charge_lire_loi(Charge *c, const char *texte) {
+    c->taille_min = 0;
+    if (strcmp(texte, "fixe") == 0) c->loi = LOI_FIXE;
+    else if (sscanf(texte, "uniforme:%lu", &c->taille_min) == 1) c->loi = LOI_UNIFORME;
+    else if (sscanf(texte, "expo:%lf:%lu", &c->taille_moyenne, &c->taille_min) >= 1
+             && c->taille_moyenne > 0) c->loi = LOI_EXPO;
+    else return -1;
+    return 0;
+}
+
+#endif
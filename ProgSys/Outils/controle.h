@@ -0,0 +1,151 @@
+#ifndef CONTROLE_H
+#define CONTROLE_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+// =================================================================
+// SESSION DE CONTRÔLE SUR UN TUBE NOMMÉ (communicant -> destinataire)
+// =================================================================
+// Avant : un open/write/close par commande, un open() BLOQUANT pour toujours si
+// le destinataire n'est pas lancé, et un strcmp sur le tampon brut du read() :
+// deux commandes arrivées ensemble ("p1\0p2\0") n'en faisaient qu'une.
+//
+// Maintenant :
+//  - le communicant ouvre le tube UNE fois (sans bloquer, avec un délai max)
+//    et le garde ouvert pour toutes les commandes suivantes ;
+//  - chaque commande est une TRAME : [longueur sur 4 octets][texte sans '\0'].
+//    Une trame (< PIPE_BUF) est écrite en UN write() : le noyau garantit qu'elle
+//    n'est jamais entrelacée avec celle d'un autre communicant ;
+//  - le destinataire accumule ce qu'il lit et découpe les trames une par une.
+#define CONTROLE_MAX 128            // Longueur max d'une commande ('\0' compris)
+#define CONTROLE_TAMPON 4096        // Tampon de réception (plusieurs trames)
+#define CONTROLE_PAUSE_US 10000     // Intervalle entre deux tentatives de connexion
+
+// --- CÔTÉ COMMUNICANT ---
+
+// Ouvre le tube en écriture. open(O_WRONLY | O_NONBLOCK) échoue (ENXIO) tant
+// que personne ne lit : on réessaie jusqu'à 'delai_ms', au lieu de bloquer.
+// Renvoie le descripteur (redevenu bloquant), ou -1 si le délai est écoulé.
+static inline int controle_connecter(const char *chemin, int delai_ms) {
+    for (int attendu = 0; ; attendu += CONTROLE_PAUSE_US / 1000) {
+        int fd = open(chemin, O_WRONLY | O_NONBLOCK);
+        if (fd != -1) {
+            // Écritures bloquantes : si le destinataire est en retard, le
+            // communicant ralentit au lieu de perdre des commandes.
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+            return fd;
+        }
+        if ((errno != ENXIO && errno != ENOENT) || attendu >= delai_ms) return -1;
+        usleep(CONTROLE_PAUSE_US);
+    }
+}
+
+// Envoie une commande sous forme de trame. Renvoie 0, ou -1 (errno = EPIPE si
+// le destinataire a fermé le tube : il faut se reconnecter).
+static inline int controle_envoyer(int fd, const char *texte) {
+    uint32_t n = (uint32_t) strnlen(texte, CONTROLE_MAX - 1);
+    char trame[sizeof(uint32_t) + CONTROLE_MAX];
+    memcpy(trame, &n, sizeof(n));
+    memcpy(trame + sizeof(n), texte, n);
+    ssize_t ecrit = write(fd, trame, sizeof(n) + n);
+    return (ecrit == (ssize_t) (sizeof(n) + n)) ? 0 : -1;
+}
+
+// Connexion PERSISTANTE à un destinataire : ouverte à la première commande,
+// gardée ouverte ensuite, refaite automatiquement s'il a été relancé.
+typedef struct {
+    const char *chemin;
+    int fd;                         // -1 : pas (encore) connecté
+} Liaison;
+
+// Envoie une commande sur la liaison (connexion à la demande, 'delai_ms' max).
+// Renvoie 0, ou -1 si personne ne lit le tube.
+// Le communicant doit ignorer SIGPIPE (sinon write() sur un tube sans lecteur le tue).
+static inline int liaison_envoyer(Liaison *l, const char *texte, int delai_ms) {
+    for (int essai = 0; essai < 2; essai++) {
+        if (l->fd == -1) l->fd = controle_connecter(l->chemin, delai_ms);
+        if (l->fd == -1) return -1;
+        if (controle_envoyer(l->fd, texte) == 0) return 0;
+        // Le destinataire est parti (EPIPE) : on referme et on retente une fois,
+        // au cas où une nouvelle instance aurait déjà rouvert le tube.
+        close(l->fd);
+        l->fd = -1;
+    }
+    return -1;
+}
+
+// Ancien protocole (versions qui lisent du texte brut) : texte + '\0', une
+// connexion par commande. Seul l'open() bloquant a été remplacé par la
+// connexion avec délai. Renvoie 0, ou -1.
+static inline int controle_envoyer_brut(const char *chemin, const char *texte, int delai_ms) {
+    int fd = controle_connecter(chemin, delai_ms);
+    if (fd == -1) return -1;
+    ssize_t n = write(fd, texte, strlen(texte) + 1);
+    close(fd);
+    return (n == (ssize_t) (strlen(texte) + 1)) ? 0 : -1;
+}
+
+// --- CÔTÉ DESTINATAIRE ---
+typedef struct {
+    int fd;
+    size_t rempli;                  // Octets reçus mais pas encore découpés
+    char tampon[CONTROLE_TAMPON];
+} Recepteur;
+
+// Crée le tube si besoin et l'ouvre.
+// O_RDWR et non O_RDONLY : on est ainsi nous-même "écrivain" du tube, donc
+//   - un communicant qui se déconnecte ne provoque pas de fin de fichier (EOF),
+//   - son open() non bloquant réussit dès que nous sommes lancés.
+// Renvoie 0, ou -1 (r->fd vaut alors -1).
+static inline int recepteur_ouvrir(Recepteur *r, const char *chemin) {
+    mkfifo(chemin, 0666);
+    r->rempli = 0;
+    r->fd = open(chemin, O_RDWR | O_NONBLOCK);
+    return r->fd == -1 ? -1 : 0;
+}
+
+// Extrait la prochaine commande complète dans 'cmd' (terminée par '\0').
+// Renvoie 1 si une commande a été extraite, 0 s'il n'y en a pas (encore).
+// À appeler en boucle : un seul read() peut apporter plusieurs trames.
+static inline int recepteur_lire(Recepteur *r, char *cmd, size_t taille) {
+    if (r->fd == -1) return 0;
+    for (;;) {
+        if (r->rempli >= sizeof(uint32_t)) {
+            uint32_t n;
+            memcpy(&n, r->tampon, sizeof(n));
+            if (n >= CONTROLE_MAX) {
+                // Trame invalide (ancien communicant ?) : on jette tout ce qui est reçu.
+                r->rempli = 0;
+                continue;
+            }
+            size_t total = sizeof(n) + n;
+            if (r->rempli >= total) {
+                size_t copie = (n < taille) ? n : taille - 1;
+                memcpy(cmd, r->tampon + sizeof(n), copie);
+                cmd[copie] = '\0';
+                r->rempli -= total;
+                memmove(r->tampon, r->tampon + total, r->rempli);
+                return 1;
+            }
+        }
+        ssize_t lus = read(r->fd, r->tampon + r->rempli, sizeof(r->tampon) - r->rempli);
+        if (lus <= 0) return 0;     // Rien de plus pour l'instant (EAGAIN)
+        r->rempli += (size_t) lus;
+    }
+}
+
+static inline void recepteur_fermer(Recepteur *r, const char *chemin) {
+    if (r->fd != -1) close(r->fd);
+    r->fd = -1;
+    unlink(chemin);
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef EVENEMENT_H
+#define EVENEMENT_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+
+// --- COMPTEURS "DESCRIPTEURS DE FICHIER" (eventfd) ---
+// Un sémaphore POSIX ne peut pas être attendu EN MÊME TEMPS qu'un tube : d'où
+// la boucle sem_trywait + usleep de ForkCommunicant V2. Un eventfd est un
+// compteur du noyau qui se manipule comme un fichier : on peut le mettre dans
+// un epoll à côté du tube et dormir sur les DEUX à la fois.
+//
+// EFD_SEMAPHORE : chaque read() retire 1 au compteur (comme sem_trywait) au
+//                 lieu de le vider d'un coup.
+// EFD_NONBLOCK  : read() sur un compteur à 0 rend EAGAIN au lieu de bloquer.
+// Créé AVANT le fork, le même compteur est partagé par le père et le fils.
+
+// Renvoie le descripteur, ou -1 (errno positionné).
+static inline int evenement_creer(unsigned int initial) {
+    return eventfd(initial, EFD_SEMAPHORE | EFD_NONBLOCK);
+}
+
+// Équivalent de sem_trywait : renvoie 1 si une unité a été prise, 0 si le compteur est à 0.
+static inline int evenement_prendre(int fd) {
+    uint64_t v;
+    return read(fd, &v, sizeof(v)) == (ssize_t) sizeof(v);
+}
+
+// Équivalent de sem_post : ajoute 1 et réveille ceux qui attendent dans epoll.
+static inline void evenement_signaler(int fd) {
+    uint64_t un = 1;
+    (void) write(fd, &un, sizeof(un));
+}
+
+// --- ATTENTE SUR PLUSIEURS DESCRIPTEURS (epoll) ---
+// Crée un epoll qui surveille 'fd1' et 'fd2' (ignoré s'il vaut -1) en lecture.
+// À créer APRÈS le fork : chaque processus doit avoir sa propre instance.
+static inline int attente_creer(int fd1, int fd2) {
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    if (ep == -1) return -1;
+    int fds[2] = { fd1, fd2 };
+    for (int k = 0; k < 2; k++) {
+        if (fds[k] == -1) continue;
+        struct epoll_event ev = { .events = EPOLLIN, .data.fd = fds[k] };
+        if (epoll_ctl(ep, EPOLL_CTL_ADD, fds[k], &ev) == -1) {
+            close(ep);
+            return -1;
+        }
+    }
+    return ep;
+}
+
+// Dort jusqu'à ce qu'au moins un descripteur soit prêt (ou qu'un signal arrive).
+// Aucun délai : pas de réveil inutile quand tout est calme.
+static inline void attente_bloquer(int ep) {
+    struct epoll_event ev[2];
+    (void) epoll_wait(ep, ev, 2, -1);
+}
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef FUTEX_H
+#define FUTEX_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <unistd.h>
+#include <errno.h>          // EAGAIN (futex_attendre sans dormir)
+#include <signal.h>         // sig_atomic_t
+#include <limits.h>         // INT_MAX
+#include <time.h>           // struct timespec (attente avec délai)
+#include <stdatomic.h>
+#include <sys/syscall.h>    // SYS_futex
+#include <linux/futex.h>    // FUTEX_WAIT, FUTEX_WAKE, FUTEX_PRIVATE_FLAG
+
+// --- FUTEX (Fast Userspace muTEX) ---
+// Un futex est un simple entier de 32 bits en mémoire.
+// Le noyau n'intervient QUE si quelqu'un doit vraiment dormir ou être réveillé :
+//   - futex_attendre(mot, v) : "Endors-moi SI *mot vaut encore v" (sinon retour immédiat)
+//   - futex_reveiller(mot, n) : "Réveille jusqu'à n dormeurs sur ce mot"
+// C'est la brique sur laquelle sont construits sem_wait et pthread_mutex_lock.
+//
+// prive = 1 : futex entre threads d'un même processus (plus rapide pour le noyau).
+// prive = 0 : futex placé en mémoire partagée entre PROCESSUS (shm_open, MAP_SHARED).
+
+// Renvoie 0 si réveillé, -1 sinon (errno = EAGAIN si la valeur avait déjà changé,
+// EINTR si un signal comme Ctrl+C a interrompu l'attente).
+static inline int futex_attendre(_Atomic unsigned int *mot, unsigned int valeur, int prive) {
+    int op = prive ? FUTEX_WAIT_PRIVATE : FUTEX_WAIT;
+    return (int) syscall(SYS_futex, (unsigned int *) mot, op, valeur, NULL, NULL, 0);
+}
+
+// Comme futex_attendre, mais pas plus de 'delai_ns' (errno = ETIMEDOUT si écoulé).
+static inline int futex_attendre_delai(_Atomic unsigned int *mot, unsigned int valeur,
+                                       unsigned long delai_ns, int prive) {
+    int op = prive ? FUTEX_WAIT_PRIVATE : FUTEX_WAIT;
+    struct timespec ts = { (time_t) (delai_ns / 1000000000UL), (long) (delai_ns % 1000000000UL) };
+    return (int) syscall(SYS_futex, (unsigned int *) mot, op, valeur, &ts, NULL, 0);
+}
+
+// Renvoie le nombre de dormeurs réveillés.
+static inline int futex_reveiller(_Atomic unsigned int *mot, int combien, int prive) {
+    int op = prive ? FUTEX_WAKE_PRIVATE : FUTEX_WAKE;
+    return (int) syscall(SYS_futex, (unsigned int *) mot, op, combien, NULL, NULL, 0);
+}
+
+// --- POINT DE RENDEZ-VOUS (PARKING) ---
+// Un côté qui doit vraiment attendre (tampon plein ou vide) "se gare" ici.
+// 'signal' est le mot futex, 'endormi' compte les dormeurs : l'autre côté
+// n'appelle le noyau que si ce compteur est non nul.
+// Peut vivre dans une globale (threads) ou dans un segment partagé (processus).
+typedef struct {
+    _Atomic unsigned int signal;
+    _Atomic int endormi;
+} Parking;
+
+// Réveille UN dormeur, UNIQUEMENT si quelqu'un s'est déclaré endormi.
+// Dans le cas courant (personne ne dort), aucun appel système n'est fait.
+static inline void parking_reveiller(Parking *p, int prive) {
+    // Barrière complète : notre publication doit être visible
+    // AVANT qu'on lise 'endormi' (sinon on pourrait rater un dormeur).
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&p->endormi, memory_order_relaxed) > 0) {
+        atomic_fetch_add_explicit(&p->signal, 1, memory_order_release);
+        futex_reveiller(&p->signal, 1, prive);
+    }
+}
+
+// Protocole d'attente en 3 temps (pour une condition quelconque) :
+//   v = parking_preparer(p);          // 1. on se déclare endormi
+//   if (condition encore fausse)      // 2. on RE-VÉRIFIE la condition
+//       parking_dormir(p, v, prive);  // 3a. on dort vraiment
+//   else parking_annuler(p);          // 3b. fausse alerte
+// L'autre côté publie PUIS lit 'endormi' : l'un des deux voit forcément l'autre.
+static inline unsigned int parking_preparer(Parking *p) {
+    // On mémorise la valeur du mot futex AVANT de se déclarer endormi.
+    unsigned int v = atomic_load_explicit(&p->signal, memory_order_acquire);
+    atomic_fetch_add_explicit(&p->endormi, 1, memory_order_seq_cst);
+    return v;
+}
+
+static inline void parking_annuler(Parking *p) {
+    atomic_fetch_sub_explicit(&p->endormi, 1, memory_order_relaxed);
+}
+
+// Renvoie 1 si l'appelant a vraiment dormi, 0 si le noyau l'a renvoyé aussitôt.
+static inline int parking_dormir(Parking *p, unsigned int v, int prive) {
+    // Si 'signal' a changé depuis parking_preparer, futex_attendre rend la main tout de suite.
+    int dormi = futex_attendre(&p->signal, v, prive) == 0 || errno != EAGAIN;
+    parking_annuler(p);
+    return dormi;
+}
+
+// Cas le plus courant : endort l'appelant tant que 'index' vaut encore 'ancienne'
+// (c.-à-d. tant que l'autre côté n'a pas bougé son index) et que '*stop' est nul.
+// Renvoie 1 si l'appelant a vraiment dormi, 0 si la re-vérification (ou le
+// noyau) l'a renvoyé tout de suite : seul le premier cas coûte un endormissement.
+static inline int parking_attendre(Parking *p, _Atomic unsigned long *index, unsigned long ancienne,
+                                   const volatile sig_atomic_t *stop, int prive) {
+    unsigned int v = parking_preparer(p);
+    if (atomic_load_explicit(index, memory_order_seq_cst) == ancienne && !*stop) {
+        return parking_dormir(p, v, prive);
+    }
+    parking_annuler(p);
+    return 0;
+}
+
+// À appeler depuis un handler de signal après avoir levé 'stop' :
+// change le mot futex et réveille, pour qu'un dormeur voie l'ordre d'arrêt.
+static inline void parking_secouer(Parking *p, int prive) {
+    atomic_fetch_add(&p->signal, 1);
+    futex_reveiller(&p->signal, INT_MAX, prive);
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef HISTO_H
+#define HISTO_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// --- HORLOGE ---
+// CLOCK_MONOTONIC ne recule jamais (contrairement à l'heure système) et passe par
+// le vDSO : pas de vrai appel système, quelques dizaines de nanosecondes.
+static inline uint64_t horloge_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// --- HISTOGRAMME LOG-LINÉAIRE ---
+// Une moyenne cache les pics : on veut p50, p99, p99.9...
+// Stocker toutes les mesures coûterait trop de mémoire, on les range donc dans des
+// "casiers" de taille FIXE (aucune allocation pendant la mesure) :
+//   - chaque puissance de 2 (1-2 µs, 2-4 µs, ...) est découpée en 16 casiers égaux,
+//   - l'erreur relative est donc au plus de 1/16 (~6 %), de 1 ns à plusieurs heures.
+// La structure est simple (que des entiers) : elle peut vivre en mémoire partagée.
+#define HISTO_SOUS_BITS 4
+#define HISTO_SOUS (1 << HISTO_SOUS_BITS)              // 16 casiers par puissance de 2
+#define HISTO_CASES ((64 - HISTO_SOUS_BITS + 1) * HISTO_SOUS)
+
+typedef struct {
+    uint64_t compte[HISTO_CASES];
+    uint64_t total;     // Nombre de mesures
+    uint64_t somme;     // Somme des mesures (pour la moyenne)
+    uint64_t max;       // Plus grande mesure
+} Histogramme;
+
+// Numéro du casier d'une valeur (en ns).
+static inline int histo_indice(uint64_t v) {
+    if (v < HISTO_SOUS) return (int) v;                   // Petites valeurs : casiers exacts
+    int e = 63 - __builtin_clzll(v);                       // Position du bit de poids fort
+    int sous = (int) (v >> (e - HISTO_SOUS_BITS)) & (HISTO_SOUS - 1);
+    return ((e - HISTO_SOUS_BITS + 1) << HISTO_SOUS_BITS) + sous;
+}
+
+// Borne HAUTE d'un casier (on annonce toujours la valeur pessimiste).
+static inline uint64_t histo_borne(int i) {
+    if (i < HISTO_SOUS) return (uint64_t) i;
+    int e = (i >> HISTO_SOUS_BITS) + HISTO_SOUS_BITS - 1;
+    uint64_t sous = (uint64_t) (i & (HISTO_SOUS - 1));
+    return ((HISTO_SOUS + sous + 1) << (e - HISTO_SOUS_BITS)) - 1;
+}
+
+static inline void histo_raz(Histogramme *h) {
+    memset(h, 0, sizeof(*h));
+}
+
+// Enregistre une mesure : quelques additions, aucune allocation.
+static inline void histo_ajouter(Histogramme *h, uint64_t v) {
+    h->compte[histo_indice(v)]++;
+    h->total++;
+    h->somme += v;
+    if (v > h->max) h->max = v;
+}
+
+static inline void histo_fusionner(Histogramme *dst, const Histogramme *src) {
+    for (int i = 0; i < HISTO_CASES; i++) dst->compte[i] += src->compte[i];
+    dst->total += src->total;
+    dst->somme += src->somme;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+// Valeur sous laquelle se trouvent 'p' % des mesures (ex : p = 99.9).
+static inline uint64_t histo_percentile(const Histogramme *h, double p) {
+    if (h->total == 0) return 0;
+    uint64_t rang = (uint64_t) (p / 100.0 * (double) h->total);
+    if (rang >= h->total) rang = h->total - 1;
+    uint64_t cumul = 0;
+    for (int i = 0; i < HISTO_CASES; i++) {
+        cumul += h->compte[i];
+        if (cumul > rang) {
+            uint64_t b = histo_borne(i);
+            return b < h->max ? b : h->max;
+        }
+    }
+    return h->max;
+}
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include "futex.h"      // Parking (le thread de journal dort ici quand tout est vide)
+
+// =================================================================
+// JOURNAL ASYNCHRONE
+// =================================================================
+// Un printf DANS la section critique (sem_wait(mutex) ... sem_post(mutex)) la
+// rallonge de tout le formatage et de l'écriture sur le terminal ou le tube :
+// l'autre côté attend le verrou pendant ce temps.
+//
+// Ici, le chemin chaud ne formate rien : il recopie un ENREGISTREMENT binaire
+// (pointeur vers la chaîne de format, un entier, le texte du message) dans un
+// anneau SPSC propre à son thread. Un thread de journal vide les anneaux,
+// formate, et écrit par gros blocs (un appel système pour des centaines de lignes).
+//
+// Si un anneau est plein, l'enregistrement est PERDU (et compté) : le chemin
+// chaud ne doit jamais attendre le journal.
+// L'ordre des lignes est garanti pour un même thread, pas entre deux threads
+// (le journal vide les anneaux l'un après l'autre).
+
+// --- NIVEAUX ---
+#define JOURNAL_RIEN  0
+#define JOURNAL_INFO  1     // Événements (commandes reçues, arrêt)
+#define JOURNAL_TRACE 2     // Chaque message écrit / lu (audit)
+
+#define JOURNAL_CANAUX 16               // Threads écrivains au plus
+#define JOURNAL_PLACES 1024             // Enregistrements par canal (puissance de 2)
+#define JOURNAL_TEXTE 128               // Texte recopié par enregistrement ('\0' compris)
+#define JOURNAL_TAMPON 65536            // Sortie accumulée avant écriture
+#define JOURNAL_PERIODE_NS 10000000UL   // Vidage au moins toutes les 10 ms
+
+// 'format' doit être une chaîne CONSTANTE (seul le pointeur est copié) qui
+// utilise au plus un %s (le texte) PUIS un %d (l'entier), dans cet ordre.
+typedef struct {
+    const char *format;
+    int entier;
+    char texte[JOURNAL_TEXTE];
+} Enregistrement;
+
+// Anneau d'UN thread écrivain vers le thread de journal (même principe que
+// l'anneau SPSC de Thread/4-Thread.c : deux index qui ne reviennent jamais à 0).
+typedef struct {
+    _Alignas(64) _Atomic unsigned long tete;    // Écrit par le thread écrivain
+    _Alignas(64) _Atomic unsigned long queue;   // Écrit par le thread de journal
+    _Alignas(64) unsigned long queue_connue;    // Copie locale de l'écrivain
+    _Atomic unsigned long perdus;               // Enregistrements jetés (anneau plein)
+    Enregistrement e[JOURNAL_PLACES];
+} Canal;
+
+typedef struct {
+    _Atomic int niveau;
+    _Atomic int nb_canaux;
+    Canal *canaux[JOURNAL_CANAUX];
+    pthread_mutex_t inscription;    // Seulement pour ajouter un canal (une fois par thread)
+    pthread_t thread;
+    int demarre;
+    _Atomic int fin;
+    Parking parking;
+} Journal;
+
+static Journal journal = { .inscription = PTHREAD_MUTEX_INITIALIZER };
+static _Thread_local Canal *journal_canal = NULL;   // Canal du thread appelant
+
+// Niveau actif : un seul chargement (le test le moins cher possible).
+static inline int journal_actif(int niveau) {
+    return niveau <= atomic_load_explicit(&journal.niveau, memory_order_relaxed);
+}
+
+// Donne un canal au thread appelant (journal_rejoindre, ou à défaut sa première écriture).
+static Canal *journal_inscrire(void) {
+    pthread_mutex_lock(&journal.inscription);
+    int n = atomic_load(&journal.nb_canaux);
+    Canal *c = NULL;
+    if (n < JOURNAL_CANAUX) {
+        c = calloc(1, sizeof(Canal));
+        if (c != NULL) {
+            journal.canaux[n] = c;
+            atomic_store_explicit(&journal.nb_canaux, n + 1, memory_order_release);
+        }
+    }
+    pthread_mutex_unlock(&journal.inscription);
+    return c;
+}
+
+// Chemin chaud : une recopie et une publication, aucun formatage, aucun verrou.
+static inline void journal_ecrire(int niveau, const char *format, const char *texte, int entier) {
+    if (!journal_actif(niveau)) return;
+    Canal *c = journal_canal;
+    if (c == NULL && (c = journal_canal = journal_inscrire()) == NULL) return;
+
+    unsigned long t = atomic_load_explicit(&c->tete, memory_order_relaxed);
+    if (t - c->queue_connue >= JOURNAL_PLACES) {
+        c->queue_connue = atomic_load_explicit(&c->queue, memory_order_acquire);
+        if (t - c->queue_connue >= JOURNAL_PLACES) {
+            atomic_store_explicit(&c->perdus, atomic_load_explicit(&c->perdus, memory_order_relaxed) + 1,
+                                  memory_order_relaxed);
+            return;
+        }
+    }
+    Enregistrement *e = &c->e[t & (JOURNAL_PLACES - 1)];
+    e->format = format;
+    e->entier = entier;
+    size_t n = texte != NULL ? strnlen(texte, JOURNAL_TEXTE - 1) : 0;
+    if (n > 0) memcpy(e->texte, texte, n);     // Recopie bornée (tronque comme snprintf)
+    e->texte[n] = '\0';
+    atomic_store_explicit(&c->tete, t + 1, memory_order_release);
+
+    // Anneau à moitié plein : on n'attend pas le prochain réveil périodique.
+    // 'queue_connue' n'est rafraîchie que sur anneau plein : on relit 'queue'
+    // ici, mais seulement une écriture sur JOURNAL_PLACES / 2.
+    if (((t + 1) & (JOURNAL_PLACES / 2 - 1)) == 0) {
+        c->queue_connue = atomic_load_explicit(&c->queue, memory_order_acquire);
+        if (t + 1 - c->queue_connue >= JOURNAL_PLACES / 2) parking_reveiller(&journal.parking, 1);
+    }
+}
+
+// Thread de journal : vide tous les canaux, formate, écrit par blocs.
+static void *journal_boucle(void *arg) {
+    static char sortie[JOURNAL_TAMPON];
+    size_t n = 0;
+    for (;;) {
+        int fin = atomic_load(&journal.fin);
+        int lus = 0;
+        int nb = atomic_load_explicit(&journal.nb_canaux, memory_order_acquire);
+        for (int k = 0; k < nb; k++) {
+            Canal *c = journal.canaux[k];
+            unsigned long q = atomic_load_explicit(&c->queue, memory_order_relaxed);
+            unsigned long t = atomic_load_explicit(&c->tete, memory_order_acquire);
+            for (; q != t; q++, lus++) {
+                const Enregistrement *e = &c->e[q & (JOURNAL_PLACES - 1)];
+                if (JOURNAL_TAMPON - n < 2 * JOURNAL_TEXTE + 128) {
+                    fwrite(sortie, 1, n, stdout);
+                    n = 0;
+                }
+                int l = snprintf(sortie + n, JOURNAL_TAMPON - n, e->format, e->texte, e->entier);
+                if (l > 0) n += ((size_t) l < JOURNAL_TAMPON - n) ? (size_t) l : JOURNAL_TAMPON - n - 1;
+            }
+            // release : l'enregistrement est lu AVANT que sa place ne soit rendue.
+            atomic_store_explicit(&c->queue, q, memory_order_release);
+        }
+        if (n > 0) {
+            fwrite(sortie, 1, n, stdout);
+            fflush(stdout);
+            n = 0;
+        }
+        if (fin && lus == 0) break;
+        if (lus == 0) {
+            unsigned int v = parking_preparer(&journal.parking);
+            if (!atomic_load(&journal.fin)) futex_attendre_delai(&journal.parking.signal, v, JOURNAL_PERIODE_NS, 1);
+            parking_annuler(&journal.parking);
+        }
+    }
+    return NULL;
+}
+
+// Lance le thread de journal. Avec JOURNAL_RIEN, aucun thread n'est créé.
+// Renvoie 0, ou -1 si le thread n'a pas pu être créé (niveau remis à JOURNAL_RIEN).
+// Le thread est créé avec TOUS les signaux bloqués (il hérite du masque) : un
+// Ctrl+C doit interrompre le sem_wait du programme, pas tomber sur le journal.
+static inline int journal_demarrer(int niveau) {
+    atomic_store(&journal.niveau, niveau);
+    if (niveau == JOURNAL_RIEN) return 0;
+    sigset_t tous, ancien;
+    sigfillset(&tous);
+    pthread_sigmask(SIG_BLOCK, &tous, &ancien);
+    int erreur = pthread_create(&journal.thread, NULL, journal_boucle, NULL);
+    pthread_sigmask(SIG_SETMASK, &ancien, NULL);
+    if (erreur != 0) {
+        atomic_store(&journal.niveau, JOURNAL_RIEN);
+        return -1;
+    }
+    journal.demarre = 1;
+    return 0;
+}
+
+// Inscrit le thread appelant tout de suite, AVANT sa boucle : sinon sa première
+// écriture prend le verrou d'inscription et fait un calloc, peut-être dans la
+// section critique que le journal doit justement alléger.
+static inline void journal_rejoindre(void) {
+    if (journal_actif(JOURNAL_INFO) && journal_canal == NULL) journal_canal = journal_inscrire();
+}
+
+// Vide tout ce qui reste, arrête le thread et signale les pertes éventuelles.
+// À appeler quand les écrivains ont fini.
+static inline void journal_arreter(void) {
+    if (!journal.demarre) return;
+    atomic_store(&journal.fin, 1);
+    parking_secouer(&journal.parking, 1);
+    pthread_join(journal.thread, NULL);
+    journal.demarre = 0;
+    unsigned long perdus = 0;
+    for (int k = 0; k < atomic_load(&journal.nb_canaux); k++) {
+        perdus += atomic_load(&journal.canaux[k]->perdus);
+        free(journal.canaux[k]);
+    }
+    atomic_store(&journal.nb_canaux, 0);
+    if (perdus > 0) fprintf(stderr, "[Journal] %lu ligne(s) perdue(s) (anneau plein)\n", perdus);
+}
+
+#endif
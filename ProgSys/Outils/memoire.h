@@ -0,0 +1,136 @@
+#ifndef MEMOIRE_H
+#define MEMOIRE_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// --- OPTIONS DE PROJECTION MÉMOIRE (pour les gros anneaux) ---
+// Par défaut, mmap donne des pages de 4 Ko allouées PARESSEUSEMENT : la première
+// écriture dans chaque page provoque un défaut de page (passage dans le noyau),
+// et chaque page coûte une entrée de TLB. Sur un anneau de plusieurs Mo, cela se
+// voit au démarrage et à chaque fois qu'on entre dans une zone encore "froide".
+#define MEM_HUGE     0x1  // Pages énormes (2 Mo) : hugetlbfs / MAP_HUGETLB, sinon THP (madvise)
+#define MEM_PREFAULT 0x2  // MAP_POPULATE : toutes les pages sont allouées DÈS le mmap
+#define MEM_VERROU   0x4  // mlock : les pages ne seront jamais évincées (swap)
+#define MEM_LECTURE  0x8  // Projection en lecture seule (outil d'observation)
+
+// Point de montage habituel de hugetlbfs (pages énormes pour des segments NOMMÉS,
+// car /dev/shm est un tmpfs qui ne sait pas faire de MAP_HUGETLB).
+#define CHEMIN_HUGETLBFS "/dev/hugepages"
+
+// Ce qui a RÉELLEMENT été obtenu (les options ne sont que des demandes).
+#define HUGE_AUCUNE  0
+#define HUGE_HUGETLB 1    // Vraies pages énormes réservées (hugetlbfs ou MAP_HUGETLB)
+#define HUGE_THP     2    // Simple conseil au noyau (Transparent Huge Pages)
+
+typedef struct {
+    void *adresse;
+    size_t taille;        // Taille réellement projetée (arrondie si pages énormes)
+    int huge;             // HUGE_AUCUNE / HUGE_HUGETLB / HUGE_THP
+    int prefault;         // 1 si MAP_POPULATE a été utilisé
+    int verrou;           // 1 si mlock a réussi
+} Projection;
+
+// Taille d'une page énorme lue dans /proc/meminfo (2 Mo si introuvable).
+static inline size_t taille_page_enorme(void) {
+    size_t ko = 2048;
+    FILE *f = fopen("/proc/meminfo", "r");
+    if (f != NULL) {
+        char ligne[128];
+        while (fgets(ligne, sizeof(ligne), f) != NULL) {
+            if (sscanf(ligne, "Hugepagesize: %zu kB", &ko) == 1) break;
+        }
+        fclose(f);
+    }
+    return ko * 1024;
+}
+
+static inline size_t arrondir(size_t taille, size_t unite) {
+    return (taille + unite - 1) / unite * unite;
+}
+
+// Étapes communes après un mmap réussi : conseil THP et mlock.
+static inline void projection_finaliser(Projection *p, int options) {
+    if ((options & MEM_HUGE) && p->huge == HUGE_AUCUNE) {
+        if (madvise(p->adresse, p->taille, MADV_HUGEPAGE) == 0) p->huge = HUGE_THP;
+    }
+    if (options & MEM_VERROU) {
+        // Échoue souvent si 'ulimit -l' est trop bas : on le signale sans s'arrêter.
+        if (mlock(p->adresse, p->taille) == 0) p->verrou = 1;
+        else perror("Avertissement : mlock");
+    }
+}
+
+// Mémoire partagée ANONYME (héritée par fork), comme dans Fork/ et ForkCommunicant/.
+// Renvoie 0, ou -1 en cas d'échec (message déjà affiché).
+static inline int projeter_anonyme(Projection *p, size_t taille, int options) {
+    int base = MAP_SHARED | MAP_ANONYMOUS | ((options & MEM_PREFAULT) ? MAP_POPULATE : 0);
+    memset(p, 0, sizeof(*p));
+    p->prefault = (options & MEM_PREFAULT) != 0;
+
+    // 1. Vraies pages énormes (échoue si aucune n'est réservée dans /proc/sys/vm/nr_hugepages)
+    if (options & MEM_HUGE) {
+        size_t t = arrondir(taille, taille_page_enorme());
+        void *a = mmap(NULL, t, PROT_READ | PROT_WRITE, base | MAP_HUGETLB, -1, 0);
+        if (a != MAP_FAILED) {
+            p->adresse = a;
+            p->taille = t;
+            p->huge = HUGE_HUGETLB;
+        }
+    }
+    // 2. Sinon, pages normales
+    if (p->adresse == NULL) {
+        void *a = mmap(NULL, taille, PROT_READ | PROT_WRITE, base, -1, 0);
+        if (a == MAP_FAILED) {
+            perror("Erreur mmap");
+            return -1;
+        }
+        p->adresse = a;
+        p->taille = taille;
+    }
+    projection_finaliser(p, options);
+    return 0;
+}
+
+// Projection d'un descripteur déjà dimensionné (shm_open ou fichier hugetlbfs).
+// 'huge' indique si le descripteur vient de hugetlbfs.
+static inline int projeter_fd(Projection *p, int fd, size_t taille, int options, int huge) {
+    int flags = MAP_SHARED | ((options & MEM_PREFAULT) ? MAP_POPULATE : 0);
+    int prot = (options & MEM_LECTURE) ? PROT_READ : PROT_READ | PROT_WRITE;
+    memset(p, 0, sizeof(*p));
+    void *a = mmap(NULL, taille, prot, flags, fd, 0);
+    if (a == MAP_FAILED) return -1;
+    p->adresse = a;
+    p->taille = taille;
+    p->prefault = (options & MEM_PREFAULT) != 0;
+    p->huge = huge ? HUGE_HUGETLB : HUGE_AUCUNE;
+    projection_finaliser(p, options);
+    return 0;
+}
+
+static inline void projection_liberer(Projection *p) {
+    if (p->verrou) munlock(p->adresse, p->taille);
+    munmap(p->adresse, p->taille);
+    p->adresse = NULL;
+}
+
+// Affiche au démarrage ce qui a VRAIMENT pris effet.
+static inline void projection_rapport(const Projection *p, const char *qui, int options) {
+    const char *huge = (p->huge == HUGE_HUGETLB) ? "pages énormes (hugetlb)"
+                     : (p->huge == HUGE_THP) ? "pages normales + conseil THP (madvise)"
+                     : "pages normales (4 Ko)";
+    printf("[%s] Mémoire : %zu octets, %s%s, pré-chargement %s, verrouillage %s\n", qui,
+           p->taille, huge,
+           ((options & MEM_HUGE) && p->huge != HUGE_HUGETLB) ? " [hugetlb indisponible]" : "",
+           p->prefault ? "OUI (MAP_POPULATE)" : "non",
+           p->verrou ? "OUI (mlock)" : ((options & MEM_VERROU) ? "ÉCHEC" : "non"));
+}
+
+#endif
@@ -0,0 +1,396 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/syscall.h>    // SYS_sched_setaffinity, SYS_mbind (appels directs, comme le futex)
+
+// --- PLACEMENT DES DEUX CÔTÉS SUR LES CŒURS ---
+// Sans consigne, l'ordonnanceur met le producteur et le consommateur où il veut :
+// parfois sur deux cœurs qui partagent un cache L2/L3 (le passage d'une ligne de
+// cache coûte quelques dizaines de ns), parfois sur deux sockets différents (la
+// ligne traverse l'interconnexion : plusieurs centaines de ns À CHAQUE message).
+// Trois façons de choisir la paire (producteur, consommateur) :
+//   -C p,c : CPU explicites ;
+//   -A     : lecture de la topologie dans /sys (cœurs distincts partageant le L2,
+//            sinon le L3, sinon le même nœud NUMA) ;
+//   -S     : sonde "ping-pong" : une ligne de cache échangée entre deux threads
+//            épinglés, pour chaque paire candidate ; on garde la plus rapide.
+// -N lie en plus la mémoire partagée au nœud NUMA du consommateur (c'est lui qui
+// la relit sans cesse ; le producteur n'y fait que des écritures).
+//
+// Les masques de CPU sont manipulés à la main et les appels système faits
+// directement (syscall) : pas besoin de _GNU_SOURCE ni de libnuma.
+#define CPU_MAX 1024
+#define CPU_MOTS (CPU_MAX / (8 * sizeof(unsigned long)))
+#define NOEUDS_MAX 64
+#define SONDE_ALLERS_RETOURS 20000      // Allers-retours mesurés par paire
+#define SONDE_DELAI_NS 200000000ULL     // Une paire qui ne répond pas en 200 ms est écartée
+#define SONDE_TOUTES_PAIRES 16          // Au-delà, on ne sonde que (premier CPU, autre)
+
+#define PLACEMENT_LIBRE    0    // Aucune consigne (comportement historique)
+#define PLACEMENT_EXPLICITE 1   // -C
+#define PLACEMENT_AUTO     2    // -A
+#define PLACEMENT_SONDE    3    // -S
+
+// Ce que partagent deux CPU (du plus proche au plus lointain, pour un échange de messages).
+#define LIEN_L2      0  // Deux cœurs distincts, même cache L2
+#define LIEN_L3      1  // Même cache L3 (même socket en général)
+#define LIEN_SMT     2  // Deux threads matériels du même cœur : L1 partagé, mais ils se
+                        // disputent aussi les unités de calcul
+#define LIEN_NOEUD   3  // Même nœud NUMA, aucun cache commun
+#define LIEN_DISTANT 4  // Nœuds NUMA différents
+#define LIEN_MEME    5  // Le même CPU (machine à un seul CPU autorisé)
+
+static const char *const noms_liens[] = {
+    "cache L2 partagé", "cache L3 partagé", "même cœur (SMT)",
+    "même nœud NUMA", "nœuds NUMA différents", "même CPU"
+};
+
+typedef struct {
+    unsigned long bits[CPU_MOTS];
+} EnsembleCpu;
+
+typedef struct {
+    int mode;           // PLACEMENT_*
+    int prod, conso;    // CPU choisis (-1 : libre)
+    int lien;           // LIEN_* entre les deux (-1 si inconnu)
+    double aller_retour_ns;     // Mesuré par la sonde (0 si non mesuré)
+    int numa;           // -N demandé
+} Placement;
+
+static inline void ens_ajouter(EnsembleCpu *e, int cpu) {
+    if (cpu >= 0 && cpu < CPU_MAX) e->bits[cpu / (8 * sizeof(unsigned long))] |= 1UL << (cpu % (8 * sizeof(unsigned long)));
+}
+
+static inline int ens_contient(const EnsembleCpu *e, int cpu) {
+    if (cpu < 0 || cpu >= CPU_MAX) return 0;
+    return (e->bits[cpu / (8 * sizeof(unsigned long))] >> (cpu % (8 * sizeof(unsigned long)))) & 1;
+}
+
+// Lit une liste au format du noyau ("0-3,8,10-11"). Renvoie 0, ou -1 si illisible.
+static inline int ens_lire_liste(EnsembleCpu *e, const char *texte) {
+    memset(e, 0, sizeof(*e));
+    const char *p = texte;
+    while (*p != '\0' && *p != '\n') {
+        char *fin;
+        long a = strtol(p, &fin, 10);
+        if (fin == p) return -1;
+        long b = a;
+        if (*fin == '-') {
+            p = fin + 1;
+            b = strtol(p, &fin, 10);
+            if (fin == p) return -1;
+        }
+        for (long c = a; c <= b; c++) ens_ajouter(e, (int) c);
+        p = (*fin == ',') ? fin + 1 : fin;
+    }
+    return 0;
+}
+
+static inline int ens_lire_fichier(EnsembleCpu *e, const char *chemin) {
+    char ligne[4096];
+    FILE *f = fopen(chemin, "r");
+    if (f == NULL) return -1;
+    int ok = fgets(ligne, sizeof(ligne), f) != NULL;
+    fclose(f);
+    return ok ? ens_lire_liste(e, ligne) : -1;
+}
+
+// CPU sur lesquels nous avons le DROIT de tourner (taskset, cgroup cpuset...).
+static inline int cpus_autorises(EnsembleCpu *e) {
+    memset(e, 0, sizeof(*e));
+    return syscall(SYS_sched_getaffinity, 0, sizeof(e->bits), e->bits) < 0 ? -1 : 0;
+}
+
+// Épingle le thread APPELANT sur 'cpu' (avec pid = 0, le noyau vise le thread
+// courant : valable aussi bien après pthread_create qu'après fork).
+// Renvoie 0, -1 en cas d'échec (message affiché), rien à faire si cpu < 0.
+static inline int placement_epingler(int cpu, const char *qui) {
+    if (cpu < 0) return 0;
+    EnsembleCpu e;
+    memset(&e, 0, sizeof(e));
+    ens_ajouter(&e, cpu);
+    if (syscall(SYS_sched_setaffinity, 0, sizeof(e.bits), e.bits) == -1) {
+        fprintf(stderr, "Avertissement : [%s] impossible de s'épingler sur le CPU %d : %s\n",
+                qui, cpu, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+// --- TOPOLOGIE (lue dans /sys/devices/system/cpu) ---
+typedef struct {
+    EnsembleCpu smt;    // Threads matériels du même cœur
+    EnsembleCpu l2;     // CPU partageant notre L2 (vide si inconnu)
+    EnsembleCpu l3;     // CPU partageant notre L3
+    int noeud;          // Nœud NUMA (0 si inconnu)
+} TopoCpu;
+
+// Nœud NUMA d'un CPU : le nœud dont la 'cpulist' le contient.
+static inline int noeud_de(int cpu) {
+    for (int n = 0; n < NOEUDS_MAX; n++) {
+        char chemin[128];
+        EnsembleCpu e;
+        snprintf(chemin, sizeof(chemin), "/sys/devices/system/node/node%d/cpulist", n);
+        if (ens_lire_fichier(&e, chemin) == 0 && ens_contient(&e, cpu)) return n;
+    }
+    return 0;
+}
+
+static inline void topo_lire(TopoCpu *t, int cpu) {
+    char chemin[160];
+    memset(t, 0, sizeof(*t));
+    snprintf(chemin, sizeof(chemin), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+    if (ens_lire_fichier(&t->smt, chemin) == -1) ens_ajouter(&t->smt, cpu);
+    for (int k = 0; k < 8; k++) {
+        int niveau = 0;
+        snprintf(chemin, sizeof(chemin), "/sys/devices/system/cpu/cpu%d/cache/index%d/level", cpu, k);
+        FILE *f = fopen(chemin, "r");
+        if (f == NULL) break;
+        if (fscanf(f, "%d", &niveau) != 1) niveau = 0;
+        fclose(f);
+        snprintf(chemin, sizeof(chemin), "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", cpu, k);
+        if (niveau == 2) ens_lire_fichier(&t->l2, chemin);
+        else if (niveau == 3) ens_lire_fichier(&t->l3, chemin);
+    }
+    t->noeud = noeud_de(cpu);
+}
+
+static inline int topo_lien(const TopoCpu *ta, int a, const TopoCpu *tb, int b) {
+    if (a == b) return LIEN_MEME;
+    if (ens_contient(&ta->smt, b)) return LIEN_SMT;
+    if (ens_contient(&ta->l2, b)) return LIEN_L2;
+    if (ens_contient(&ta->l3, b)) return LIEN_L3;
+    return ta->noeud == tb->noeud ? LIEN_NOEUD : LIEN_DISTANT;
+}
+
+// Liste des CPU autorisés. Renvoie leur nombre.
+static inline int cpus_candidats(int *cpus) {
+    EnsembleCpu e;
+    int n = 0;
+    if (cpus_autorises(&e) == -1) return 0;
+    for (int c = 0; c < CPU_MAX; c++) if (ens_contient(&e, c)) cpus[n++] = c;
+    return n;
+}
+
+// -A : la paire de CPU autorisés la mieux reliée (LIEN_* le plus petit ; à
+// égalité, les plus petits numéros). Un seul CPU : les deux côtés le partagent.
+static inline int placement_auto(Placement *pl) {
+    static int cpus[CPU_MAX];
+    int n = cpus_candidats(cpus);
+    if (n == 0) return -1;
+    pl->prod = pl->conso = cpus[0];
+    pl->lien = LIEN_MEME;
+    if (n == 1) return 0;
+    TopoCpu *topo = malloc(n * sizeof(TopoCpu));
+    if (topo == NULL) return -1;
+    for (int k = 0; k < n; k++) topo_lire(&topo[k], cpus[k]);
+    for (int a = 0; a < n; a++) {
+        for (int b = a + 1; b < n; b++) {
+            int l = topo_lien(&topo[a], cpus[a], &topo[b], cpus[b]);
+            if (l < pl->lien) {
+                pl->prod = cpus[a];
+                pl->conso = cpus[b];
+                pl->lien = l;
+            }
+        }
+    }
+    free(topo);
+    return 0;
+}
+
+// --- SONDE PING-PONG ---
+// Une seule ligne de cache : le thread A écrit 2k+1 et attend 2k+2, le thread B
+// attend 2k+1 et répond 2k+2. Chaque aller-retour = deux transferts de la ligne
+// d'un cœur à l'autre, exactement ce que paient 'tete' et 'queue' à chaque message.
+typedef struct {
+    _Alignas(64) _Atomic long balle;
+    _Alignas(64) _Atomic int abandon;   // A a dépassé son délai : B doit partir aussi
+    int cpu_b;
+} Raquette;
+
+static inline uint64_t placement_horloge_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void *sonde_renvoyer(void *arg) {
+    Raquette *r = arg;
+    if (placement_epingler(r->cpu_b, "Sonde") == -1) {
+        atomic_store(&r->abandon, 1);
+        return NULL;
+    }
+    for (long k = 0; k < SONDE_ALLERS_RETOURS; k++) {
+        while (atomic_load_explicit(&r->balle, memory_order_acquire) != 2 * k + 1)
+            if (atomic_load_explicit(&r->abandon, memory_order_relaxed)) return NULL;
+        atomic_store_explicit(&r->balle, 2 * k + 2, memory_order_release);
+    }
+    return NULL;
+}
+
+// Aller-retour moyen (ns) entre les CPU 'a' et 'b', ou -1 si la mesure échoue.
+// Le thread appelant s'épingle sur 'a' le temps de la mesure puis retrouve son
+// masque d'origine.
+static inline double sonde_paire(int a, int b) {
+    EnsembleCpu origine;
+    if (cpus_autorises(&origine) == -1 || placement_epingler(a, "Sonde") == -1) return -1;
+    Raquette r;
+    atomic_init(&r.balle, 0);
+    atomic_init(&r.abandon, 0);
+    r.cpu_b = b;
+    pthread_t th;
+    double resultat = -1;
+    if (pthread_create(&th, NULL, sonde_renvoyer, &r) == 0) {
+        uint64_t debut = placement_horloge_ns();
+        long k;
+        for (k = 0; k < SONDE_ALLERS_RETOURS && !atomic_load(&r.abandon); k++) {
+            atomic_store_explicit(&r.balle, 2 * k + 1, memory_order_release);
+            while (atomic_load_explicit(&r.balle, memory_order_acquire) != 2 * k + 2) {
+                if (placement_horloge_ns() - debut > SONDE_DELAI_NS) {
+                    atomic_store(&r.abandon, 1);
+                    break;
+                }
+            }
+        }
+        if (!atomic_load(&r.abandon)) resultat = (double) (placement_horloge_ns() - debut) / SONDE_ALLERS_RETOURS;
+        atomic_store(&r.abandon, 1);
+        pthread_join(th, NULL);
+    }
+    syscall(SYS_sched_setaffinity, 0, sizeof(origine.bits), origine.bits);
+    return resultat;
+}
+
+// -S : sonde toutes les paires (ou, sur une grosse machine, le premier CPU contre
+// chacun des autres), affiche les mesures et garde la paire la plus rapide.
+static inline int placement_sonder(Placement *pl) {
+    static int cpus[CPU_MAX];
+    int n = cpus_candidats(cpus);
+    if (n == 0) return -1;
+    pl->prod = pl->conso = cpus[0];
+    pl->lien = LIEN_MEME;
+    if (n == 1) {
+        printf("[Placement] Un seul CPU autorisé : rien à sonder.\n");
+        return 0;
+    }
+    TopoCpu *topo = malloc(n * sizeof(TopoCpu));
+    if (topo == NULL) return -1;
+    for (int k = 0; k < n; k++) topo_lire(&topo[k], cpus[k]);
+    double meilleur = -1;
+    int premiers = (n <= SONDE_TOUTES_PAIRES) ? n : 1;
+    printf("[Placement] Sonde ping-pong (%d allers-retours par paire) :\n", SONDE_ALLERS_RETOURS);
+    for (int a = 0; a < premiers; a++) {
+        for (int b = a + 1; b < n; b++) {
+            double ns = sonde_paire(cpus[a], cpus[b]);
+            int l = topo_lien(&topo[a], cpus[a], &topo[b], cpus[b]);
+            if (ns < 0) {
+                printf("  CPU %3d <-> %3d : pas de réponse (%s)\n", cpus[a], cpus[b], noms_liens[l]);
+                continue;
+            }
+            printf("  CPU %3d <-> %3d : %8.1f ns (%s)\n", cpus[a], cpus[b], ns, noms_liens[l]);
+            if (meilleur < 0 || ns < meilleur) {
+                meilleur = ns;
+                pl->prod = cpus[a];
+                pl->conso = cpus[b];
+                pl->lien = l;
+            }
+        }
+    }
+    pl->aller_retour_ns = meilleur > 0 ? meilleur : 0;
+    free(topo);
+    return 0;
+}
+
+// -C "p,c" : CPU explicites. Renvoie 0, ou -1 si le texte est invalide.
+static inline int placement_lire(Placement *pl, const char *texte) {
+    if (sscanf(texte, "%d,%d", &pl->prod, &pl->conso) != 2 || pl->prod < 0 || pl->conso < 0
+        || pl->prod >= CPU_MAX || pl->conso >= CPU_MAX) {
+        fprintf(stderr, "Option -C : attendu 'cpu_producteur,cpu_consommateur' (ex. -C 2,3)\n");
+        return -1;
+    }
+    pl->mode = PLACEMENT_EXPLICITE;
+    return 0;
+}
+
+static inline void placement_init(Placement *pl) {
+    pl->mode = PLACEMENT_LIBRE;
+    pl->prod = pl->conso = -1;
+    pl->lien = -1;
+    pl->aller_retour_ns = 0;
+    pl->numa = 0;
+}
+
+// Après la lecture des options : calcule la paire (-A, -S) et affiche le choix.
+// À appeler AVANT de créer les threads / de faire le fork.
+static inline void placement_preparer(Placement *pl) {
+    if (pl->mode == PLACEMENT_AUTO && placement_auto(pl) == -1) pl->mode = PLACEMENT_LIBRE;
+    if (pl->mode == PLACEMENT_SONDE && placement_sonder(pl) == -1) pl->mode = PLACEMENT_LIBRE;
+    if (pl->mode == PLACEMENT_EXPLICITE) {
+        TopoCpu ta, tb;
+        topo_lire(&ta, pl->prod);
+        topo_lire(&tb, pl->conso);
+        pl->lien = topo_lien(&ta, pl->prod, &tb, pl->conso);
+    }
+    if (pl->mode == PLACEMENT_LIBRE) {
+        printf("[Placement] Libre (l'ordonnanceur choisit).\n");
+        return;
+    }
+    printf("[Placement] Producteur sur le CPU %d, consommateur sur le CPU %d (%s, nœud %d)",
+           pl->prod, pl->conso, noms_liens[pl->lien], noeud_de(pl->conso));
+    if (pl->aller_retour_ns > 0) printf(", aller-retour %.1f ns", pl->aller_retour_ns);
+    printf("\n");
+}
+
+// --- MÉMOIRE SUR LE NŒUD DU CONSOMMATEUR (-N) ---
+// mbind(MPOL_PREFERRED) : les pages de [adresse, adresse + taille) sont prises
+// sur ce nœud tant qu'il en a ; MPOL_MF_MOVE déplace celles déjà touchées
+// (initialisation, MAP_POPULATE). 'adresse' doit être alignée sur une page
+// (c'est le cas d'un retour de mmap). Renvoie 0 si lié, 1 s'il n'y a qu'un
+// nœud (rien à faire), -1 en cas d'échec (message affiché).
+#define POLITIQUE_PREFEREE 1    // MPOL_PREFERRED (linux/mempolicy.h)
+#define POLITIQUE_DEPLACER 2    // MPOL_MF_MOVE
+
+static inline int noeuds_nombre(void) {
+    int n = 0;
+    for (int k = 0; k < NOEUDS_MAX; k++) {
+        char chemin[64];
+        snprintf(chemin, sizeof(chemin), "/sys/devices/system/node/node%d", k);
+        if (access(chemin, F_OK) == 0) n = k + 1;
+    }
+    return n > 0 ? n : 1;
+}
+
+static inline int placement_lier_memoire(const Placement *pl, void *adresse, size_t taille) {
+    if (!pl->numa) return 0;
+    int cpu = pl->conso;
+    if (cpu < 0) {
+        fprintf(stderr, "Avertissement : -N sans CPU consommateur choisi (-C, -A ou -S) : ignoré.\n");
+        return -1;
+    }
+    int noeud = noeud_de(cpu);
+    if (noeuds_nombre() == 1) {
+        printf("[Placement] Un seul nœud NUMA : mémoire déjà locale.\n");
+        return 1;
+    }
+    unsigned long masque[NOEUDS_MAX / (8 * sizeof(unsigned long))] = { 0 };
+    masque[0] = 1UL << noeud;
+    if (syscall(SYS_mbind, adresse, taille, POLITIQUE_PREFEREE, masque, NOEUDS_MAX + 1,
+                POLITIQUE_DEPLACER) == -1) {
+        fprintf(stderr, "Avertissement : mbind (nœud %d) : %s\n", noeud, strerror(errno));
+        return -1;
+    }
+    printf("[Placement] Mémoire partagée (%zu octets) liée au nœud %d (celui du consommateur).\n",
+           taille, noeud);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef REACTEUR_H
+#define REACTEUR_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>    // Pauses sans bloquer le thread (un minuteur par tâche)
+
+// --- RÉACTEUR : PLUSIEURS TÂCHES SUR UN SEUL THREAD ---
+// ForkCommunicant V2/V3 entrelacent à la main "lire le tube, essayer le
+// compteur, dormir" dans UNE boucle par processus : ajouter un anneau, c'est
+// réécrire la boucle. Ici chaque activité (produire dans un anneau, consommer
+// un anneau, écouter un tube de commandes) est une TÂCHE écrite comme du code
+// séquentiel, qui se SUSPEND quand elle doit attendre un descripteur (eventfd,
+// tube, minuteur) au lieu de bloquer le thread. Un seul epoll_wait réveille
+// exactement les tâches dont le descripteur est prêt : pas d'intervalle de
+// scrutation, pas de thread par file, des dizaines de files par processus.
+//
+// C'est l'équivalent C des coroutines "sans pile" : la fonction d'une tâche est
+// un grand 'switch' sur le numéro de ligne où elle s'était arrêtée (technique
+// des protothreads). Conséquence à ne pas oublier : les variables LOCALES ne
+// survivent pas à une suspension ; tout ce qui doit durer vit dans la structure
+// de la tâche (son "cadre"), qui commence par un champ Tache.
+//
+//   int ma_tache(Reacteur *r, Tache *t) {
+//       MonCadre *c = (MonCadre *) t;
+//       TACHE_DEBUT(t);
+//       for (c->k = 0; ; c->k++) {
+//           TACHE_ATTENDRE(r, t, fd, evenement_prendre(fd));  // "co_await"
+//           ...
+//       }
+//       TACHE_FIN(t);
+//   }
+#define TACHE_SUSPENDUE 0
+#define TACHE_TERMINEE 1
+#define REACTEUR_EVENEMENTS 64      // Réveils traités par epoll_wait
+
+typedef struct Reacteur Reacteur;
+typedef struct Tache Tache;
+typedef int (*FonctionTache)(Reacteur *r, Tache *t);
+
+struct Tache {
+    FonctionTache reprendre;
+    const char *nom;
+    int etape;          // Ligne où reprendre (0 : début)
+    int minuteur;       // timerfd de la tâche (-1 tant qu'elle n'a pas fait de pause)
+    int terminee;
+    uint64_t suspensions;
+};
+
+struct Reacteur {
+    int ep;
+    int actives;        // Tâches lancées et pas encore terminées
+    int arret;          // Levé par une tâche (commande "stop") : on sort de la boucle
+    uint64_t reveils;   // Retours d'epoll_wait
+    uint64_t reprises;  // Tâches relancées
+};
+
+// 'etape' reçoit le numéro de la ligne ; 'case __LINE__' est l'endroit où la
+// fonction reprendra. 'condition' est réévaluée à chaque reprise : la tâche ne
+// continue que lorsqu'elle est vraie (si elle l'est tout de suite, aucune suspension).
+#define TACHE_DEBUT(t) switch ((t)->etape) { case 0:
+#define TACHE_ATTENDRE(r, t, fd, condition)                             \
+    do {                                                                \
+        (t)->etape = __LINE__;                                          \
+        __attribute__((fallthrough));                                   \
+        case __LINE__:                                                  \
+        if (!(condition)) {                                             \
+            if (reacteur_surveiller((r), (t), (fd)) == -1) return TACHE_TERMINEE; \
+            return TACHE_SUSPENDUE;                                     \
+        }                                                               \
+    } while (0)
+// Pause de 'ms' millisecondes sans bloquer les autres tâches.
+#define TACHE_DORMIR(r, t, ms)                                          \
+    do {                                                                \
+        if (tache_minuteur((t), (ms)) == 0)                             \
+            TACHE_ATTENDRE((r), (t), (t)->minuteur, minuteur_echu((t)->minuteur)); \
+    } while (0)
+#define TACHE_FIN(t) } (t)->etape = -1; return TACHE_TERMINEE
+
+// Réveil UNIQUE (EPOLLONESHOT) : le descripteur est désarmé dès qu'il réveille
+// la tâche, qui le réarme en se suspendant à nouveau. Un seul appel système
+// (MOD) dans le cas courant, ADD la première fois.
+static inline int reacteur_surveiller(Reacteur *r, Tache *t, int fd) {
+    struct epoll_event ev = { .events = EPOLLIN | EPOLLONESHOT, .data.ptr = t };
+    t->suspensions++;
+    if (epoll_ctl(r->ep, EPOLL_CTL_MOD, fd, &ev) == 0) return 0;
+    if (errno == ENOENT && epoll_ctl(r->ep, EPOLL_CTL_ADD, fd, &ev) == 0) return 0;
+    fprintf(stderr, "[%s] epoll_ctl (fd %d) : %s\n", t->nom, fd, strerror(errno));
+    return -1;
+}
+
+static inline int reacteur_init(Reacteur *r) {
+    memset(r, 0, sizeof(*r));
+    r->ep = epoll_create1(EPOLL_CLOEXEC);
+    return r->ep == -1 ? -1 : 0;
+}
+
+// Arme le minuteur de la tâche (créé à la première pause). Renvoie 0 s'il faut
+// attendre, 1 si 'ms' vaut 0 (rien à attendre), -1 en cas d'erreur.
+static inline int tache_minuteur(Tache *t, int ms) {
+    if (ms <= 0) return 1;
+    if (t->minuteur == -1) {
+        t->minuteur = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (t->minuteur == -1) return -1;
+    }
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = ms / 1000;
+    its.it_value.tv_nsec = (long) (ms % 1000) * 1000000L;
+    return timerfd_settime(t->minuteur, 0, &its, NULL) == -1 ? -1 : 0;
+}
+
+// Vrai (et acquitté) si le minuteur a expiré.
+static inline int minuteur_echu(int fd) {
+    uint64_t n;
+    return read(fd, &n, sizeof(n)) == (ssize_t) sizeof(n);
+}
+
+// Démarre une tâche : elle s'exécute tout de suite jusqu'à sa première attente.
+static inline void reacteur_lancer(Reacteur *r, Tache *t, FonctionTache f, const char *nom) {
+    t->reprendre = f;
+    t->nom = nom;
+    t->etape = 0;
+    t->minuteur = -1;
+    t->terminee = 0;
+    t->suspensions = 0;
+    r->actives++;
+    if (f(r, t) == TACHE_TERMINEE) {
+        t->terminee = 1;
+        r->actives--;
+    }
+}
+
+// Boucle principale : dort dans epoll_pwait jusqu'à ce qu'un descripteur
+// attendu soit prêt, relance sa tâche, recommence. S'arrête quand toutes les
+// tâches sont terminées, quand l'une d'elles lève 'r->arret', ou sur '*stop'.
+// 'masque' : signaux débloqués PENDANT l'attente seulement (comme sigsuspend :
+// un Ctrl+C arrivé juste avant epoll_pwait ne peut pas être manqué).
+static inline void reacteur_tourner(Reacteur *r, const volatile sig_atomic_t *stop, const sigset_t *masque) {
+    struct epoll_event ev[REACTEUR_EVENEMENTS];
+    while (!*stop && !r->arret && r->actives > 0) {
+        int n = epoll_pwait(r->ep, ev, REACTEUR_EVENEMENTS, -1, masque);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            perror("epoll_pwait");
+            break;
+        }
+        r->reveils++;
+        for (int k = 0; k < n && !r->arret; k++) {
+            Tache *t = ev[k].data.ptr;
+            if (t->terminee) continue;
+            r->reprises++;
+            if (t->reprendre(r, t) == TACHE_TERMINEE) {
+                t->terminee = 1;
+                r->actives--;
+            }
+        }
+    }
+}
+
+static inline void tache_liberer(Tache *t) {
+    if (t->minuteur != -1) close(t->minuteur);
+    t->minuteur = -1;
+}
+
+static inline void reacteur_fermer(Reacteur *r) {
+    close(r->ep);
+    r->ep = -1;
+}
+
+#endif
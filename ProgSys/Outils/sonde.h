@@ -0,0 +1,85 @@
+#ifndef SONDE_H
+#define SONDE_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdint.h>
+#include <signal.h>
+#include "histo.h"      // horloge_ns + Histogramme log-linéaire
+
+// --- SONDES DE LATENCE PAR OPÉRATION ---
+// Une moyenne cache les blocages rares qui font vraiment mal. Ici, chaque
+// opération de synchronisation est chronométrée (horloge_ns, via le vDSO) et
+// rangée dans un Histogramme : taille fixe, aucune allocation pendant la mesure.
+// Désactivées (actif = 0), les sondes ne lisent même pas l'horloge.
+#define SONDE_ATTENTE   0   // Durée d'un sem_wait (places libres / items existants)
+#define SONDE_VERROU    1   // Détention du verrou : entrée -> sortie de section critique
+#define SONDE_TRANSFERT 2   // Passage complet d'un message : dépôt demandé -> message retiré
+#define SONDE_NB 3
+
+typedef struct {
+    const char *qui;            // Nom affiché ("Producteur", "Fils"...)
+    int actif;
+    Histogramme h[SONDE_NB];
+} Sondes;
+
+// Demande d'affichage : levée par le handler de SIGUSR1, traitée par la boucle
+// principale (printf n'est pas utilisable dans un handler de signal).
+static volatile sig_atomic_t sonde_demande = 0;
+
+static void sonde_handler(int sig) {
+    sonde_demande = 1;
+}
+
+static inline void sondes_init(Sondes *s, const char *qui, int actif) {
+    s->qui = qui;
+    s->actif = actif;
+    for (int k = 0; k < SONDE_NB; k++) histo_raz(&s->h[k]);
+}
+
+// Installe le handler de SIGUSR1 ("kill -USR1 <pid>" : affiche les histogrammes).
+// Pas de SA_RESTART : un sem_wait en cours est interrompu (EINTR), la boucle
+// repasse par son début et voit la demande tout de suite.
+static inline void sonde_installer(void) {
+    struct sigaction sa;
+    sa.sa_handler = sonde_handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGUSR1, &sa, NULL);
+}
+
+// Début d'une mesure (0 si les sondes sont désactivées).
+static inline uint64_t sonde_debut(const Sondes *s) {
+    return s->actif ? horloge_ns() : 0;
+}
+
+// Fin d'une mesure commencée à 'debut' (ignorée si 'debut' vaut 0).
+static inline void sonde_fin(Sondes *s, int quoi, uint64_t debut) {
+    if (debut != 0) histo_ajouter(&s->h[quoi], horloge_ns() - debut);
+}
+
+static inline void sonde_afficher(const Sondes *s) {
+    static const char *noms[SONDE_NB] = { "attente sem_wait", "tenue du verrou", "transfert complet" };
+    printf("=== Latences [%s] (µs : moyenne / p50 / p90 / p99 / p99.9 / max) ===\n", s->qui);
+    for (int k = 0; k < SONDE_NB; k++) {
+        const Histogramme *h = &s->h[k];
+        if (h->total == 0) continue;
+        printf("  %-18s %8llu mesures : %9.1f / %9.1f / %9.1f / %9.1f / %9.1f / %9.1f\n",
+               noms[k], (unsigned long long) h->total,
+               (double) h->somme / h->total / 1e3,
+               histo_percentile(h, 50) / 1e3, histo_percentile(h, 90) / 1e3,
+               histo_percentile(h, 99) / 1e3, histo_percentile(h, 99.9) / 1e3,
+               h->max / 1e3);
+    }
+    fflush(stdout);
+}
+
+// À appeler en début de boucle : affiche si SIGUSR1 est arrivé.
+static inline void sonde_verifier(const Sondes *s) {
+    if (sonde_demande && s->actif) {
+        sonde_demande = 0;
+        sonde_afficher(s);
+    }
+}
+
+#endif
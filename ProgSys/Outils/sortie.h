@@ -0,0 +1,199 @@
+#ifndef SORTIE_H
+#define SORTIE_H
+// ^-- HEADER GUARD : Empêche l'inclusion multiple de ce fichier
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/uio.h>        // writev : plusieurs tampons en UN appel système
+#include "histo.h"          // horloge_ns + Histogramme (latence des vidages)
+
+// --- SORTIE GROUPÉE DES MESSAGES CONSOMMÉS ---
+// Un printf par message, c'est un write() par message dès que stdout n'est pas
+// un terminal (ou un par ligne s'il l'est) : sous charge, le consommateur passe
+// plus de temps dans le noyau que dans l'anneau. Ici, chaque message lu est
+// RECOPIÉ (texte + '\n') dans des blocs alignés sur une page ; les blocs
+// remplis partent ensemble, en un seul writev, quand :
+//   - 'seuil' octets sont en attente (taille),
+//   - ou le plus ancien message en attente a 'delai' ms (âge) : vérifié en
+//     écrivant, et par le consommateur quand il n'a plus rien à lire (il dort
+//     au plus sortie_reste_ns, cf. 7-consommateur).
+// Vider à chaque fois que la file se vide donnerait des lots minuscules : un
+// consommateur plus rapide que le producteur trouve la file vide presque à
+// chaque message.
+// Le descripteur peut être un fichier, un tube ou stdout ("-").
+// Blocs alignés sur 4 Kio : compatibles avec O_DIRECT et copiés page par page
+// par le noyau.
+#define SORTIE_BLOC (64UL << 10)            // 64 Kio par bloc
+#define SORTIE_BLOCS_MAX 1024               // Seuil max : 64 Mio
+#define SORTIE_SEUIL_DEFAUT (1UL << 20)     // 1 Mio
+#define SORTIE_DELAI_DEFAUT_MS 100
+#define SORTIE_ALIGNEMENT 4096
+
+typedef struct {
+    int fd;
+    int possede;                // 1 : ouvert par nous (à fermer)
+    int nb_blocs;               // seuil = nb_blocs * SORTIE_BLOC
+    char *blocs[SORTIE_BLOCS_MAX];
+    int bloc;                   // Bloc en cours de remplissage
+    size_t rempli;              // Octets dans ce bloc
+    size_t en_attente;          // Octets pas encore écrits (tous blocs)
+    uint64_t delai_ns;
+    uint64_t premier_ns;        // Heure du plus ancien octet en attente
+    // Bilan
+    uint64_t debut_ns;
+    uint64_t enregistrements;
+    uint64_t octets;            // Écrits pour de bon
+    uint64_t vidages;
+    uint64_t erreurs;
+    Histogramme latence;        // Durée d'un vidage (writev complet)
+} Sortie;
+
+// 'chemin' : fichier (ajout en fin), tube nommé, ou "-" pour stdout.
+// 'seuil' en octets (arrondi au bloc), 'delai_ms' : âge max d'un message en attente.
+// Renvoie 0, ou -1 (message affiché).
+static inline int sortie_ouvrir(Sortie *s, const char *chemin, size_t seuil, int delai_ms) {
+    memset(s, 0, sizeof(*s));
+    if (strcmp(chemin, "-") == 0) {
+        s->fd = STDOUT_FILENO;
+    } else {
+        s->fd = open(chemin, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (s->fd == -1) {
+            perror(chemin);
+            return -1;
+        }
+        s->possede = 1;
+    }
+    s->nb_blocs = (int) ((seuil + SORTIE_BLOC - 1) / SORTIE_BLOC);
+    if (s->nb_blocs < 1) s->nb_blocs = 1;
+    if (s->nb_blocs > SORTIE_BLOCS_MAX) s->nb_blocs = SORTIE_BLOCS_MAX;
+    for (int k = 0; k < s->nb_blocs; k++) {
+        if (posix_memalign((void **) &s->blocs[k], SORTIE_ALIGNEMENT, SORTIE_BLOC) != 0) {
+            fprintf(stderr, "Sortie : plus de mémoire pour %d blocs\n", s->nb_blocs);
+            while (k-- > 0) free(s->blocs[k]);
+            if (s->possede) close(s->fd);
+            s->fd = -1;
+            return -1;
+        }
+    }
+    s->delai_ns = (uint64_t) delai_ms * 1000000ULL;
+    s->debut_ns = horloge_ns();
+    histo_raz(&s->latence);
+    return 0;
+}
+
+// Écrit tout ce qui est en attente : UN writev pour tous les blocs (plus,
+// rarement, des reprises si le noyau n'a pris qu'une partie, sur un tube plein).
+static inline int sortie_vider(Sortie *s) {
+    if (s->en_attente == 0) return 0;
+    uint64_t t0 = horloge_ns();
+    struct iovec iov[SORTIE_BLOCS_MAX];
+    int n = 0;
+    for (int k = 0; k <= s->bloc; k++) {
+        iov[n].iov_base = s->blocs[k];
+        iov[n].iov_len = (k < s->bloc) ? SORTIE_BLOC : s->rempli;
+        if (iov[n].iov_len > 0) n++;
+    }
+    int premier = 0;
+    while (premier < n) {
+        ssize_t ecrits = writev(s->fd, iov + premier, n - premier);
+        if (ecrits == -1) {
+            if (errno == EINTR) continue;
+            s->erreurs++;
+            perror("Sortie : writev");
+            break;      // On jette le lot plutôt que de bloquer la consommation
+        }
+        s->octets += (uint64_t) ecrits;
+        while (premier < n && (size_t) ecrits >= iov[premier].iov_len) {
+            ecrits -= (ssize_t) iov[premier].iov_len;
+            premier++;
+        }
+        if (premier < n) {
+            iov[premier].iov_base = (char *) iov[premier].iov_base + ecrits;
+            iov[premier].iov_len -= (size_t) ecrits;
+        }
+    }
+    s->bloc = 0;
+    s->rempli = 0;
+    s->en_attente = 0;
+    s->vidages++;
+    histo_ajouter(&s->latence, horloge_ns() - t0);
+    return 0;
+}
+
+// Ajoute un enregistrement (le texte du message puis '\n').
+static inline void sortie_ecrire(Sortie *s, const char *texte, size_t n) {
+    if (s->en_attente == 0) s->premier_ns = horloge_ns();
+    for (size_t fait = 0; fait <= n; ) {
+        if (s->rempli == SORTIE_BLOC) {
+            if (s->bloc + 1 == s->nb_blocs) {
+                sortie_vider(s);                // Seuil de TAILLE atteint
+                s->premier_ns = horloge_ns();   // La suite de l'enregistrement attend depuis maintenant
+            } else {
+                s->bloc++;
+                s->rempli = 0;
+            }
+        }
+        size_t place = SORTIE_BLOC - s->rempli;
+        if (fait == n) {
+            // Le séparateur, seul (le texte peut finir pile au bout d'un bloc).
+            s->blocs[s->bloc][s->rempli++] = '\n';
+            s->en_attente++;
+            break;
+        }
+        size_t copie = (n - fait < place) ? n - fait : place;
+        memcpy(s->blocs[s->bloc] + s->rempli, texte + fait, copie);
+        s->rempli += copie;
+        s->en_attente += copie;
+        fait += copie;
+    }
+    s->enregistrements++;
+    // Seuil d'ÂGE : vérifié tous les 64 messages (l'horloge n'est pas gratuite).
+    if ((s->enregistrements & 63) == 0 && horloge_ns() - s->premier_ns >= s->delai_ns) sortie_vider(s);
+}
+
+// Temps (ns) avant que le plus ancien message en attente n'atteigne l'âge
+// maximal : 0 s'il faut vider maintenant, UINT64_MAX si rien n'attend. Un
+// consommateur qui n'a plus rien à lire ne dort pas plus longtemps que ça.
+static inline uint64_t sortie_reste_ns(const Sortie *s) {
+    if (s->en_attente == 0) return UINT64_MAX;
+    uint64_t age = horloge_ns() - s->premier_ns;
+    return age >= s->delai_ns ? 0 : s->delai_ns - age;
+}
+
+// Seuil d'âge seul (à appeler quand le consommateur se réveille sans message).
+static inline void sortie_echeance(Sortie *s) {
+    if (sortie_reste_ns(s) == 0) sortie_vider(s);
+}
+
+// Débit et latence des vidages depuis l'ouverture (sur stderr : stdout peut
+// être la sortie elle-même).
+static inline void sortie_rapport(const Sortie *s, const char *qui) {
+    double secondes = (horloge_ns() - s->debut_ns) / 1e9;
+    const Histogramme *h = &s->latence;
+    fprintf(stderr, "[%s] Sortie : %llu message(s), %.1f Mo en %.2f s (%.1f Mo/s, %.0f msg/s), "
+            "%llu vidage(s) de %.0f Ko en moyenne%s\n", qui,
+            (unsigned long long) s->enregistrements, s->octets / 1e6, secondes,
+            secondes > 0 ? s->octets / 1e6 / secondes : 0.0,
+            secondes > 0 ? s->enregistrements / secondes : 0.0,
+            (unsigned long long) s->vidages, s->vidages ? s->octets / 1e3 / s->vidages : 0.0,
+            s->erreurs ? " [ERREURS d'écriture]" : "");
+    if (h->total > 0)
+        fprintf(stderr, "[%s] Latence d'un vidage : moyenne %.1f µs, p50 %.1f µs, p99 %.1f µs, max %.1f µs\n",
+                qui, h->somme / 1e3 / h->total, histo_percentile(h, 50) / 1e3,
+                histo_percentile(h, 99) / 1e3, h->max / 1e3);
+}
+
+// Vide, ferme, libère.
+static inline void sortie_fermer(Sortie *s) {
+    sortie_vider(s);
+    if (s->possede) close(s->fd);
+    for (int k = 0; k < s->nb_blocs; k++) free(s->blocs[k]);
+    s->fd = -1;
+}
+
+#endif
@@ -6,6 +6,13 @@
 #include <string.h>
 #include <signal.h>     // Nécessaire pour capturer Ctrl+C (SIGINT)
 #include <errno.h>      // Pour analyser les erreurs (comme EINTR)
+#include <stdint.h>
+#include <stdatomic.h>  // Deques du pool : indices atomiques (vol par CAS)
+#include <getopt.h>     // Lecture des options -m -j -W -c -w -p
+#include "../Outils/sonde.h" // Histogrammes de latence (option -m, affichés sur SIGUSR1)
+#include "../Outils/journal.h" // Traces hors section critique (option -j)
+#include "../Outils/attente.h" // Stratégie d'attente de chaque côté (option -W)
+#include "../Outils/futex.h"   // Parking des ouvriers du pool (option -c)
 
 #define N 10            // La taille physique du tableau (tampon)
 #define TAILLE_MSG 64   // Taille max du texte dans chaque case
@@ -13,6 +20,8 @@
 // --- STRUCTURE DE DONNÉES ---
 typedef struct {
     char texte[TAILLE_MSG];
+    uint64_t depose_ns; // Heure de la demande de dépôt (mesure du transfert, 0 sinon)
+    int numero;         // Rang du message (fixe son coût de traitement simulé, cf. cout_ns)
 } Donnee;
 
 // --- VARIABLES GLOBALES (L'espace commun) ---
@@ -36,6 +45,136 @@ sem_t items_existants;  // Compteur : Combien de messages sont prêts à être l
 // PTHREAD_MUTEX_INITIALIZER crée le mutex en état "déverrouillé" au départ.
 pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER; 
 
+// Histogrammes de latence : un jeu par thread (chacun n'écrit que le sien).
+Sondes sondes_prod, sondes_conso;
+
+// Stratégie d'attente et compteurs : un jeu par thread.
+Attente attente_prod, attente_conso;
+
+// Rythme et coût simulé (options -p et -w).
+int pause_ms = 1000;
+uint64_t travail_ns = 0;
+
+
+// ============================================================================
+// POOL DE CONSOMMATEURS AVEC VOL DE TRAVAIL (option -c)
+// ============================================================================
+// Un seul consommateur traite tout en série. Avec -c n, le thread consommateur
+// devient un DISTRIBUTEUR : il vide le tampon et range chaque message, à tour
+// de rôle, dans la deque d'un des n OUVRIERS. Si les coûts sont inégaux, ce
+// partage statique laisse des ouvriers sans rien pendant que d'autres
+// accumulent : un ouvrier dont la deque est vide VOLE donc dans celle des
+// autres. Aucun verrou central :
+//   - 'bas' n'est écrit que par le distributeur (dépôt, comme la tête d'un SPSC) ;
+//   - 'haut' est avancé par CAS, par le propriétaire comme par les voleurs :
+//     un seul gagne chaque message (c'est l'opération "steal" de Chase-Lev,
+//     le propriétaire prenant lui aussi par le haut : ordre FIFO conservé).
+#define OUVRIERS_MAX 12     // + producteur + distributeur : sous JOURNAL_CANAUX
+#define DEQUE_TAILLE 256    // Messages par deque (puissance de 2)
+
+typedef struct {
+    _Alignas(64) _Atomic unsigned long haut;    // Prochain message à prendre (CAS)
+    _Alignas(64) _Atomic unsigned long bas;     // Prochaine case à remplir (distributeur)
+    Donnee tab[DEQUE_TAILLE];
+} Deque;
+
+// Compteurs d'un ouvrier : écrits par lui seul, lus "au vol" pour le bilan.
+typedef struct {
+    _Alignas(64) uint64_t traites;  // Messages traités (les siens + les volés)
+    uint64_t voles;                 // ... dont pris dans la deque d'un autre
+    uint64_t conflits;              // CAS perdus (un autre a pris le message)
+    uint64_t endormis;              // Fois où TOUT était vide
+    uint64_t occupe_ns;             // Temps passé à traiter
+} StatsOuvrier;
+
+typedef struct {
+    int taille;                     // Nombre d'ouvriers (0 : un consommateur classique)
+    uint64_t debut_ns;
+    uint64_t distribues;            // Distributeur seul
+    uint64_t plein;                 // Fois où toutes les deques étaient pleines
+    _Alignas(64) Parking parking_ouvriers;      // Les ouvriers sans travail dorment ici
+    _Alignas(64) Parking parking_distributeur;  // Le distributeur dort ici si tout est plein
+    Deque deques[OUVRIERS_MAX];
+    StatsOuvrier stats[OUVRIERS_MAX];
+} Pool;
+
+Pool pool;
+
+// Distributeur : range 'item' dans 'd'. Renvoie 0 si la deque est pleine.
+int deque_deposer(Deque *d, const Donnee *item) {
+    unsigned long b = atomic_load_explicit(&d->bas, memory_order_relaxed);
+    unsigned long t = atomic_load_explicit(&d->haut, memory_order_acquire);
+    if (b - t >= DEQUE_TAILLE) return 0;
+    d->tab[b % DEQUE_TAILLE] = *item;
+    // release : le message est visible AVANT le nouveau 'bas'.
+    atomic_store_explicit(&d->bas, b + 1, memory_order_release);
+    return 1;
+}
+
+// Propriétaire ou voleur : prend le plus ancien message de 'd'.
+// Renvoie 1 (copié dans '*item') ou 0 si la deque est vide.
+// La copie est faite AVANT le CAS : si un autre a gagné entre-temps, elle est
+// simplement jetée (le distributeur ne réécrit une case qu'après avoir vu
+// 'haut' la dépasser, donc jamais pendant qu'un CAS sur elle peut réussir).
+int deque_prendre(Deque *d, Donnee *item, uint64_t *conflits) {
+    unsigned long t = atomic_load_explicit(&d->haut, memory_order_acquire);
+    for (;;) {
+        unsigned long b = atomic_load_explicit(&d->bas, memory_order_acquire);
+        if (t >= b) return 0;
+        *item = d->tab[t % DEQUE_TAILLE];
+        if (atomic_compare_exchange_weak_explicit(&d->haut, &t, t + 1,
+                                                  memory_order_acq_rel, memory_order_acquire)) {
+            return 1;
+        }
+        (*conflits)++;  // 't' a été rechargé : on retente sur le suivant
+    }
+}
+
+// Relectures seq_cst : utilisées APRÈS parking_preparer (cf. futex.h).
+int pool_vide(void) {
+    for (int k = 0; k < pool.taille; k++)
+        if (atomic_load(&pool.deques[k].haut) < atomic_load(&pool.deques[k].bas)) return 0;
+    return 1;
+}
+
+int pool_plein(void) {
+    for (int k = 0; k < pool.taille; k++)
+        if (atomic_load(&pool.deques[k].bas) - atomic_load(&pool.deques[k].haut) < DEQUE_TAILLE) return 0;
+    return 1;
+}
+
+// Coût simulé d'un message (calcul, sans dormir) : INÉGAL exprès, un message
+// sur 8 coûte 8 fois plus. Avec un partage à tour de rôle sur 2, 4 ou 8
+// ouvriers, c'est toujours le même ouvrier qui les reçoit tous.
+uint64_t cout_ns(int numero) {
+    return (numero % 8 == 0) ? 8 * travail_ns : travail_ns;
+}
+
+void travailler(uint64_t ns) {
+    if (ns == 0) return;
+    uint64_t fin = horloge_ns() + ns;
+    while (horloge_ns() < fin) { }
+}
+
+// Bilan du pool : une ligne par ouvrier (utilisation = temps occupé / temps écoulé).
+void pool_afficher(void) {
+    double ecoule = (double) (horloge_ns() - pool.debut_ns);
+    uint64_t total = 0, voles = 0;
+    printf("--- Pool : %d ouvrier(s), %llu message(s) distribué(s), toutes deques pleines %llu fois ---\n",
+           pool.taille, (unsigned long long) pool.distribues, (unsigned long long) pool.plein);
+    for (int k = 0; k < pool.taille; k++) {
+        const StatsOuvrier *st = &pool.stats[k];
+        total += st->traites;
+        voles += st->voles;
+        printf("  [Ouvrier %2d] %8llu traité(s) dont %8llu volé(s), %6llu conflit(s), %6llu sommeil(s), "
+               "utilisation %5.1f %%\n", k, (unsigned long long) st->traites, (unsigned long long) st->voles,
+               (unsigned long long) st->conflits, (unsigned long long) st->endormis,
+               ecoule > 0 ? 100.0 * st->occupe_ns / ecoule : 0.0);
+    }
+    printf("  Total : %llu traité(s), %llu volé(s) (%.1f %%)\n", (unsigned long long) total,
+           (unsigned long long) voles, total ? 100.0 * voles / total : 0.0);
+}
+
 
 // ============================================================================
 // GESTIONNAIRE DE SIGNAL (L'interception du Ctrl+C)
@@ -54,43 +193,54 @@ void handler(int sig) {
     // Cela débloque immédiatement les sem_wait dans les threads.
     sem_post(&places_libres);   
     sem_post(&items_existants);
+    // Les ouvriers et le distributeur du pool dorment sur des futex.
+    parking_secouer(&pool.parking_ouvriers, 1);
+    parking_secouer(&pool.parking_distributeur, 1);
 }
 
 // ============================================================================
 // ROUTINE DU PRODUCTEUR (L'écrivain)
 // ============================================================================
 void * producteur(void * arg) {
+    journal_rejoindre();    // Canal pris avant la boucle, pas sous le mutex
     int k = 0; // Compteur local pour générer des messages différents
 
     // On boucle tant que le drapeau 'stop' est à 0 (Faux)
     while (!stop) { 
         Donnee item;
         // Préparation du message en local (hors de la zone partagée, pas besoin de protection)
+        item.numero = k;
         snprintf(item.texte, TAILLE_MSG, "ThreadMsg %d", k++);
+        uint64_t t0 = sonde_debut(&sondes_prod);
+        item.depose_ns = t0;
         
         // --- ÉTAPE 1 : Attente d'une place libre ---
         // sem_wait décrémente le compteur. Si compteur == 0, le thread DORT ici.
         // Il se réveille si :
         //   a) Le consommateur libère une place (sem_post)
         //   b) Le handler simule une place (Ctrl+C)
-        if (sem_wait(&places_libres) != 0) {
+        if (attente_sem(&attente_prod, &places_libres, &stop) != 0) {
             // Si sem_wait a échoué (interruption), on vérifie si on doit arrêter
             if (stop) break; 
         }
+        sonde_fin(&sondes_prod, SONDE_ATTENTE, t0);
         
         // Sécurité : Si on a été réveillé par le handler (Ctrl+C), on sort tout de suite
         if (stop) break; 
 
         // --- ÉTAPE 2 : Section Critique (Accès exclusif) ---
         pthread_mutex_lock(&mutex); // Je prends la clé (les autres attendent)
+        uint64_t t1 = sonde_debut(&sondes_prod);
 
         // Écriture réelle en mémoire partagée
         tab[i] = item; 
-        printf("-> Producteur : Ecrit '%s' index %d\n", item.texte, i);
+        // Trace asynchrone : une recopie, le formatage se fait hors du verrou.
+        journal_ecrire(JOURNAL_TRACE, "-> Producteur : Ecrit '%s' index %d\n", item.texte, i);
         
         // Calcul circulaire de l'index : 0, 1, ..., 9, puis retour à 0
         i = (i + 1) % N;
         
+        sonde_fin(&sondes_prod, SONDE_VERROU, t1);
         pthread_mutex_unlock(&mutex); // Je rends la clé
         // --- Fin Section Critique ---
 
@@ -98,11 +248,11 @@ void * producteur(void * arg) {
         // On prévient le consommateur qu'il y a un nouveau message à lire
         sem_post(&items_existants);
 
-        sleep(1); // On ralentit pour observer le résultat
+        if (pause_ms > 0) usleep((useconds_t) pause_ms * 1000); // On ralentit pour observer le résultat
     }
     
     // Ce message ne s'affiche que si on sort du while (donc si stop == 1)
-    printf("--- Arrêt (SIGINT) : Fin du thread Producteur ---\n");
+    journal_ecrire(JOURNAL_INFO, "--- Arrêt (SIGINT) : Fin du thread Producteur ---\n", NULL, 0);
     pthread_exit(NULL); // Termine ce thread proprement
 }
 
@@ -110,47 +260,183 @@ void * producteur(void * arg) {
 // ROUTINE DU CONSOMMATEUR (Le lecteur)
 // ============================================================================
 void * consommateur(void * arg) {
+    journal_rejoindre();
     while (!stop) {
         Donnee item;
         
         // --- ÉTAPE 1 : Attente de quelque chose à lire ---
         // Si items_existants == 0, on dort ici.
-        if (sem_wait(&items_existants) != 0) {
+        uint64_t t0 = sonde_debut(&sondes_conso);
+        if (attente_sem(&attente_conso, &items_existants, &stop) != 0) {
             if (stop) break; // Interruption système
         }
+        sonde_fin(&sondes_conso, SONDE_ATTENTE, t0);
         
         // Si on a été réveillé par le handler (et pas par le producteur), on sort.
         if (stop) break; 
 
         // --- ÉTAPE 2 : Section Critique ---
         pthread_mutex_lock(&mutex); // Je verrouille l'accès
+        uint64_t t1 = sonde_debut(&sondes_conso);
 
         // Lecture depuis la mémoire partagée
         item = tab[j]; 
-        printf("<- Consommateur : Lu '%s' index %d\n", item.texte, j);
+        journal_ecrire(JOURNAL_TRACE, "<- Consommateur : Lu '%s' index %d\n", item.texte, j);
         
         // Avancée circulaire de l'index de lecture
         j = (j + 1) % N;
         
+        sonde_fin(&sondes_conso, SONDE_VERROU, t1);
         pthread_mutex_unlock(&mutex); // Je déverrouille
         // --- Fin Section Critique ---
+        if (item.depose_ns != 0) sonde_fin(&sondes_conso, SONDE_TRANSFERT, item.depose_ns);
 
         // --- ÉTAPE 3 : Signalement ---
         // On prévient le producteur qu'une case s'est libérée
         sem_post(&places_libres);
 
-        sleep(1);
+        travailler(cout_ns(item.numero));
+        if (pause_ms > 0) usleep((useconds_t) pause_ms * 1000);
     }
 
     // Ce message s'affiche quand la boucle est brisée par le Ctrl+C
-    printf("--- Arrêt (SIGINT) : Fin du thread Consommateur ---\n");
+    journal_ecrire(JOURNAL_INFO, "--- Arrêt (SIGINT) : Fin du thread Consommateur ---\n", NULL, 0);
+    pthread_exit(NULL);
+}
+
+// ============================================================================
+// ROUTINE DU DISTRIBUTEUR (le consommateur, en mode pool)
+// ============================================================================
+// Même côté "lecture" du tampon que le consommateur ; le traitement est confié
+// aux ouvriers, à tour de rôle (une deque pleine est sautée).
+void * distributeur(void * arg) {
+    journal_rejoindre();
+    int suivant = 0;
+
+    while (!stop) {
+        Donnee item;
+
+        // --- ÉTAPE 1 : Attente d'un message (comme le consommateur) ---
+        if (attente_sem(&attente_conso, &items_existants, &stop) != 0) {
+            if (stop) break;
+        }
+        if (stop) break;
+
+        // --- ÉTAPE 2 : Section Critique (lecture du tampon) ---
+        pthread_mutex_lock(&mutex);
+        item = tab[j];
+        j = (j + 1) % N;
+        pthread_mutex_unlock(&mutex);
+        sem_post(&places_libres);
+
+        // --- ÉTAPE 3 : Dépôt dans la deque d'un ouvrier ---
+        int depose = 0;
+        while (!stop && !depose) {
+            for (int k = 0; k < pool.taille && !depose; k++) {
+                int cible = (suivant + k) % pool.taille;
+                if (deque_deposer(&pool.deques[cible], &item)) {
+                    depose = 1;
+                    suivant = (cible + 1) % pool.taille;
+                }
+            }
+            if (depose) break;
+            // Toutes les deques sont pleines : les ouvriers sont saturés.
+            pool.plein++;
+            unsigned int v = parking_preparer(&pool.parking_distributeur);
+            if (pool_plein() && !stop) parking_dormir(&pool.parking_distributeur, v, 1);
+            else parking_annuler(&pool.parking_distributeur);
+        }
+        if (!depose) break;
+        pool.distribues++;
+        parking_reveiller(&pool.parking_ouvriers, 1);
+    }
+
+    journal_ecrire(JOURNAL_INFO, "--- Arrêt (SIGINT) : Fin du thread Distributeur ---\n", NULL, 0);
+    pthread_exit(NULL);
+}
+
+// ============================================================================
+// ROUTINE D'UN OUVRIER DU POOL
+// ============================================================================
+// D'abord sa propre deque ; vide, il vole chez les autres (en commençant par
+// son voisin, pour que deux ouvriers sans travail ne visent pas la même) ;
+// tout est vide, il dort jusqu'au prochain dépôt.
+void * ouvrier(void * arg) {
+    journal_rejoindre();
+    int moi = (int) (intptr_t) arg;
+    StatsOuvrier *st = &pool.stats[moi];
+
+    while (!stop) {
+        Donnee item;
+        int pris = deque_prendre(&pool.deques[moi], &item, &st->conflits);
+        for (int k = 1; k < pool.taille && !pris; k++) {
+            pris = deque_prendre(&pool.deques[(moi + k) % pool.taille], &item, &st->conflits);
+            if (pris) st->voles++;
+        }
+
+        if (!pris) {
+            // Protocole du parking : se déclarer endormi, PUIS revérifier.
+            unsigned int v = parking_preparer(&pool.parking_ouvriers);
+            if (pool_vide() && !stop) {
+                st->endormis++;
+                parking_dormir(&pool.parking_ouvriers, v, 1);
+            } else {
+                parking_annuler(&pool.parking_ouvriers);
+            }
+            continue;
+        }
+        // Une place s'est libérée : le distributeur attendait peut-être.
+        parking_reveiller(&pool.parking_distributeur, 1);
+
+        uint64_t t0 = horloge_ns();
+        journal_ecrire(JOURNAL_TRACE, "<- Ouvrier : Traite '%s' (ouvrier %d)\n", item.texte, moi);
+        travailler(cout_ns(item.numero));
+        st->occupe_ns += horloge_ns() - t0;
+        st->traites++;
+    }
     pthread_exit(NULL);
 }
 
 // ============================================================================
 // FONCTION PRINCIPALE (Le Chef d'orchestre)
 // ============================================================================
-int main() {
+// Usage : ./3-Thread [-m] [-j niveau] [-W prod,conso] [-c ouvriers] [-w travail_us] [-p pause_ms]
+//   -m : mesure chaque attente, chaque détention du verrou et chaque transfert.
+//        "kill -USR1 <pid>" affiche les histogrammes, qui sont aussi affichés à l'arrêt.
+//   -j : traces (0 = aucune, 1 = événements, 2 = chaque message, par défaut).
+//        Elles sont écrites par un thread de journal, plus dans la section critique.
+//   -W : stratégie d'attente de chaque côté (bloque, spin, cede, adapte ; "bloque" par défaut).
+//        Un seul nom vaut pour les deux côtés. Les compteurs sont affichés à l'arrêt.
+//   -c : pool de 'ouvriers' consommateurs (1 à OUVRIERS_MAX) alimentés par un
+//        distributeur, avec vol de travail ; 0 (défaut) : un seul consommateur.
+//        Bilan par ouvrier (vols, utilisation) à l'arrêt et sur SIGUSR1.
+//   -w : coût simulé d'un message, en µs (un sur 8 coûte 8 fois plus ; 0 par défaut)
+//   -p : pause du producteur (et du consommateur seul) entre deux messages,
+//        1000 ms par défaut, 0 = pleine vitesse
+int main(int argc, char *argv[]) {
+    int mesurer = 0;
+    int niveau = JOURNAL_TRACE;
+    int strategie_prod = ATTENTE_BLOQUE, strategie_conso = ATTENTE_BLOQUE;
+    int opt;
+    while ((opt = getopt(argc, argv, "mj:W:c:w:p:")) != -1) {
+        if (opt == 'm') mesurer = 1;
+        else if (opt == 'j') niveau = atoi(optarg);
+        else if (opt == 'W') { if (attente_lire_paire(optarg, &strategie_prod, &strategie_conso) == -1) exit(1); }
+        else if (opt == 'c') pool.taille = atoi(optarg);
+        else if (opt == 'w') travail_ns = (uint64_t) atol(optarg) * 1000;
+        else if (opt == 'p') pause_ms = atoi(optarg);
+        else exit(1);
+    }
+    if (pool.taille < 0 || pool.taille > OUVRIERS_MAX || pause_ms < 0) {
+        fprintf(stderr, "Usage : %s [-m] [-j niveau] [-W p,c] [-c ouvriers 0..%d] [-w travail_us] [-p pause_ms]\n",
+                argv[0], OUVRIERS_MAX);
+        exit(1);
+    }
+    attente_init(&attente_prod, strategie_prod);
+    attente_init(&attente_conso, strategie_conso);
+    sondes_init(&sondes_prod, "Producteur", mesurer);
+    sondes_init(&sondes_conso, "Consommateur", mesurer);
+
     // --- 1. Configuration du Signal (Le téléphone rouge) ---
     struct sigaction sa;
     sa.sa_handler = handler;  // Quelle fonction appeler ? -> handler
@@ -159,9 +445,22 @@ int main() {
     
     // On active l'écoute sur SIGINT (le signal envoyé par Ctrl+C)
     sigaction(SIGINT, &sa, NULL); 
+    sonde_installer();
+
+    // Les threads créés héritent du masque de signaux : on y bloque SIGINT et
+    // SIGUSR1, qui arrivent donc TOUJOURS au main (les sem_post du handler
+    // suffisent à réveiller les threads). Le main peut alors attendre les
+    // signaux (sigsuspend) au lieu de dormir dans pthread_join.
+    sigset_t signaux, ancien;
+    sigemptyset(&signaux);
+    sigaddset(&signaux, SIGINT);
+    sigaddset(&signaux, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signaux, &ancien);
+    if (journal_demarrer(niveau) == -1) perror("Avertissement : thread de journal");
 
     // Déclaration des identifiants des threads
     pthread_t th_prod, th_conso; 
+    pthread_t th_ouvriers[OUVRIERS_MAX];
 
     printf("--- Debut avec Threads (Faites Ctrl+C pour stopper et voir les messages) ---\n");
 
@@ -178,19 +477,52 @@ int main() {
         exit(1);
     }
 
-    if (pthread_create(&th_conso, NULL, consommateur, NULL) != 0) {
+    // En mode pool, le thread consommateur devient le distributeur.
+    if (pthread_create(&th_conso, NULL, pool.taille > 0 ? distributeur : consommateur, NULL) != 0) {
         perror("Erreur création consommateur");
         exit(1);
     }
+
+    pool.debut_ns = horloge_ns();
+    for (int k = 0; k < pool.taille; k++) {
+        if (pthread_create(&th_ouvriers[k], NULL, ouvrier, (void *) (intptr_t) k) != 0) {
+            perror("Erreur création ouvrier");
+            exit(1);
+        }
+    }
     
     // --- 4. Attente (Le main se met en pause) ---
-    // Le main reste bloqué sur ces lignes tant que les threads n'ont pas fini.
-    // Comme ils sont dans une boucle infinie, le main ne bouge plus jusqu'au Ctrl+C.
+    // Le main dort jusqu'au Ctrl+C ; un SIGUSR1 le réveille pour afficher les
+    // histogrammes (lecture "au vol" de compteurs que les threads continuent
+    // d'écrire : une photo approximative, mais sans aucun verrou ajouté).
+    // sigsuspend débloque les signaux ET s'endort d'un seul coup : un Ctrl+C
+    // arrivé juste après le test de 'stop' ne peut pas être manqué.
+    while (!stop) {
+        sigsuspend(&ancien);
+        if (sonde_demande) {
+            sonde_demande = 0;
+            if (mesurer) {
+                sonde_afficher(&sondes_prod);
+                sonde_afficher(&sondes_conso);
+            }
+            if (pool.taille > 0) pool_afficher();
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &ancien, NULL);
     pthread_join(th_prod, NULL); 
     pthread_join(th_conso, NULL);
+    for (int k = 0; k < pool.taille; k++) pthread_join(th_ouvriers[k], NULL);
+    journal_arreter();   // Écrit les dernières traces avant le bilan
 
     // Si on arrive ici, c'est que les threads sont finis (grâce au Ctrl+C)
     printf("--- Fin du processus principal ---\n");
+    attente_rapport(&attente_prod, "Producteur");
+    attente_rapport(&attente_conso, pool.taille > 0 ? "Distributeur" : "Consommateur");
+    if (pool.taille > 0) pool_afficher();
+    if (mesurer) {
+        sonde_afficher(&sondes_prod);
+        sonde_afficher(&sondes_conso);
+    }
 
     // --- 5. Nettoyage ---
     // On détruit les outils de synchronisation pour libérer les ressources système
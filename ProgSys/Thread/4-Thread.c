@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>    // Nécessaire pour créer des threads (processus légers)
+#include <string.h>
+#include <signal.h>     // Nécessaire pour capturer Ctrl+C (SIGINT)
+#include <errno.h>
+#include <stdatomic.h>  // Opérations atomiques C11 (load/store acquire/release)
+#include "../Outils/futex.h"
+#include "../Outils/placement.h" // Épinglage des deux threads (-C, -A, -S)
+#include "../Outils/attente.h" // Boucle active / cession / futex selon le côté (-W)
+
+#define N 10            // La taille physique du tableau (tampon)
+#define TAILLE_MSG 64   // Taille max du texte dans chaque case
+#define TAILLE_LIGNE 64 // Taille d'une ligne de cache (octets)
+
+// --- STRUCTURE DE DONNÉES ---
+// Identique à la V3 : seul le mécanisme de synchronisation change.
+typedef struct {
+    char texte[TAILLE_MSG];
+} Donnee;
+
+// --- L'ANNEAU SPSC (Single Producer / Single Consumer) ---
+// VERSION 4 : Plus de mutex ni de sémaphores.
+// Il n'y a qu'UN écrivain de 'tete' (le producteur) et qu'UN écrivain de 'queue'
+// (le consommateur). Ces index ne reviennent jamais à 0 : ce sont des numéros de
+// séquence qui croissent (0, 1, 2, ...). La case utilisée est 'sequence % N'.
+//   - Nombre d'items présents = tete - queue
+//   - Tampon vide  : tete == queue
+//   - Tampon plein : tete - queue == N
+//
+// _Alignas(TAILLE_LIGNE) : chaque index vit sur sa propre ligne de cache.
+// Sans cela, chaque écriture de l'un invaliderait le cache de l'autre (faux partage).
+typedef struct {
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long tete;  // Prochaine séquence à écrire (Producteur)
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long queue; // Prochaine séquence à lire (Consommateur)
+    _Alignas(TAILLE_LIGNE) Parking parking_prod;        // Le producteur dort ici si c'est plein
+    _Alignas(TAILLE_LIGNE) Parking parking_conso;       // Le consommateur dort ici si c'est vide
+    _Alignas(TAILLE_LIGNE) Donnee tab[N];               // Le tampon circulaire
+} AnneauSPSC;
+
+AnneauSPSC anneau; // Variable globale : visible par tous les threads (initialisée à 0)
+
+// --- GESTION DE L'ARRÊT ---
+// volatile sig_atomic_t : seul type garanti lisible/écrivable depuis un handler.
+volatile sig_atomic_t stop = 0;
+
+// --- PLACEMENT ---
+// Choisi par main AVANT la création des threads ; chacun s'épingle lui-même en démarrant.
+Placement placement;
+
+// Stratégie d'attente et compteurs : un jeu par thread.
+Attente attente_prod, attente_conso;
+
+
+// ============================================================================
+// GESTIONNAIRE DE SIGNAL (L'interception du Ctrl+C)
+// ============================================================================
+void handler(int sig) {
+    stop = 1;
+
+    // Comme en V3, il faut RÉVEILLER les threads endormis pour qu'ils voient 'stop'.
+    // On change le mot futex puis on réveille (syscall autorisé dans un handler).
+    parking_secouer(&anneau.parking_prod, 1);
+    parking_secouer(&anneau.parking_conso, 1);
+}
+
+
+// ============================================================================
+// ROUTINE DU PRODUCTEUR (L'écrivain)
+// ============================================================================
+void * producteur(void * arg) {
+    placement_epingler(placement.prod, "Producteur");
+    int k = 0;
+    // Copie locale de 'queue' : on ne relit la vraie valeur (ligne de cache de l'autre)
+    // que lorsque le tampon NOUS SEMBLE plein.
+    unsigned long queue_connue = 0;
+
+    while (!stop) {
+        Donnee item;
+        snprintf(item.texte, TAILLE_MSG, "ThreadMsg %d", k++);
+
+        // 'tete' n'est écrit que par nous : lecture relâchée suffisante.
+        unsigned long t = atomic_load_explicit(&anneau.tete, memory_order_relaxed);
+
+        // --- ÉTAPE 1 : Attente d'une place libre (seulement si VRAIMENT plein) ---
+        while (!stop && t - queue_connue >= N) {
+            // acquire : on voit la case libérée par le consommateur avant de l'écraser
+            queue_connue = atomic_load_explicit(&anneau.queue, memory_order_acquire);
+            if (t - queue_connue >= N) {
+                attente_index(&attente_prod, &anneau.parking_prod, &anneau.queue, queue_connue, &stop, 1);
+            }
+        }
+        if (stop) break;
+
+        // --- ÉTAPE 2 : Écriture (aucun verrou : la case t % N nous appartient) ---
+        anneau.tab[t % N] = item;
+        printf("-> Producteur : Ecrit '%s' index %lu\n", item.texte, t % N);
+
+        // --- ÉTAPE 3 : Publication ---
+        // release : la copie de 'item' est visible AVANT la nouvelle valeur de 'tete'.
+        atomic_store_explicit(&anneau.tete, t + 1, memory_order_release);
+        parking_reveiller(&anneau.parking_conso, 1);
+
+        sleep(1); // On ralentit pour observer le résultat
+    }
+
+    printf("--- Arrêt (SIGINT) : Fin du thread Producteur ---\n");
+    pthread_exit(NULL);
+}
+
+// ============================================================================
+// ROUTINE DU CONSOMMATEUR (Le lecteur)
+// ============================================================================
+void * consommateur(void * arg) {
+    placement_epingler(placement.conso, "Consommateur");
+    unsigned long tete_connue = 0; // Copie locale de 'tete' (même principe)
+
+    while (!stop) {
+        Donnee item;
+        unsigned long q = atomic_load_explicit(&anneau.queue, memory_order_relaxed);
+
+        // --- ÉTAPE 1 : Attente d'un item (seulement si VRAIMENT vide) ---
+        while (!stop && q == tete_connue) {
+            // acquire : on voit le contenu de la case écrit par le producteur
+            tete_connue = atomic_load_explicit(&anneau.tete, memory_order_acquire);
+            if (q == tete_connue) {
+                attente_index(&attente_conso, &anneau.parking_conso, &anneau.tete, tete_connue, &stop, 1);
+            }
+        }
+        if (stop) break;
+
+        // --- ÉTAPE 2 : Lecture ---
+        item = anneau.tab[q % N];
+        printf("<- Consommateur : Lu '%s' index %lu\n", item.texte, q % N);
+
+        // --- ÉTAPE 3 : Libération de la case ---
+        // release : notre lecture est terminée AVANT que le producteur ne réutilise la case.
+        atomic_store_explicit(&anneau.queue, q + 1, memory_order_release);
+        parking_reveiller(&anneau.parking_prod, 1);
+
+        sleep(1);
+    }
+
+    printf("--- Arrêt (SIGINT) : Fin du thread Consommateur ---\n");
+    pthread_exit(NULL);
+}
+
+// ============================================================================
+// FONCTION PRINCIPALE
+// ============================================================================
+// Usage : ./4-Thread [-C cpu_prod,cpu_conso | -A | -S] [-W prod,conso]
+//   -C : épingle le producteur et le consommateur sur ces CPU
+//   -A : choisit deux cœurs partageant un cache (L2, sinon L3) d'après /sys
+//   -S : mesure l'aller-retour d'une ligne de cache entre les CPU et garde la paire la plus rapide
+//   -W : stratégie d'attente de chaque côté (bloque, spin, cede, adapte ; "bloque" par défaut)
+int main(int argc, char *argv[]) {
+    placement_init(&placement);
+    int strategie_prod = ATTENTE_BLOQUE, strategie_conso = ATTENTE_BLOQUE;
+    int opt;
+    while ((opt = getopt(argc, argv, "C:ASW:")) != -1) {
+        if (opt == 'C') { if (placement_lire(&placement, optarg) == -1) exit(1); }
+        else if (opt == 'A') placement.mode = PLACEMENT_AUTO;
+        else if (opt == 'S') placement.mode = PLACEMENT_SONDE;
+        else if (opt == 'W') { if (attente_lire_paire(optarg, &strategie_prod, &strategie_conso) == -1) exit(1); }
+        else exit(1);
+    }
+    attente_init(&attente_prod, strategie_prod);
+    attente_init(&attente_conso, strategie_conso);
+
+    // --- 1. Configuration du Signal ---
+    struct sigaction sa;
+    sa.sa_handler = handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGINT, &sa, NULL);
+
+    pthread_t th_prod, th_conso;
+
+    printf("--- Debut avec Threads V4 (Anneau sans verrou SPSC, Ctrl+C pour stopper) ---\n");
+    placement_preparer(&placement);
+
+    // --- 2. Pas de sémaphores à initialiser ---
+    // 'anneau' est une globale : tete = queue = 0 (tampon vide) dès le départ.
+
+    // --- 3. Lancement des Threads ---
+    if (pthread_create(&th_prod, NULL, producteur, NULL) != 0) {
+        perror("Erreur création producteur");
+        exit(1);
+    }
+
+    if (pthread_create(&th_conso, NULL, consommateur, NULL) != 0) {
+        perror("Erreur création consommateur");
+        exit(1);
+    }
+
+    // --- 4. Attente ---
+    pthread_join(th_prod, NULL);
+    pthread_join(th_conso, NULL);
+
+    printf("--- Fin du processus principal ---\n");
+    attente_rapport(&attente_prod, "Producteur");
+    attente_rapport(&attente_conso, "Consommateur");
+
+    // --- 5. Nettoyage ---
+    // Rien à détruire : les futex ne sont que des entiers en mémoire.
+    return 0;
+}
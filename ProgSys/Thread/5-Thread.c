@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>    // Nécessaire pour créer des threads (processus légers)
+#include <string.h>
+#include <signal.h>     // Nécessaire pour capturer Ctrl+C (SIGINT)
+#include <errno.h>
+#include <stdatomic.h>  // Opérations atomiques C11 (CAS, load/store acquire/release)
+#include "../Outils/futex.h"
+
+#define N 10            // La taille physique du tableau (tampon)
+#define TAILLE_MSG 64   // Taille max du texte dans chaque case
+#define TAILLE_LIGNE 64 // Taille d'une ligne de cache (octets)
+#define MAX_THREADS 64  // Nombre max de producteurs (et de consommateurs)
+
+// --- STRUCTURE DE DONNÉES ---
+typedef struct {
+    char texte[TAILLE_MSG];
+} Donnee;
+
+// --- UNE CASE DU TAMPON ---
+// VERSION 5 : chaque case porte son propre numéro de séquence.
+// C'est lui (et non plus un mutex global) qui dit à qui appartient la case :
+//   sequence == pos      -> case LIBRE, prête pour le producteur qui a le ticket 'pos'
+//   sequence == pos + 1  -> case PLEINE, prête pour le consommateur qui a le ticket 'pos'
+// Après lecture, le consommateur la rend pour le tour suivant : sequence = pos + N.
+typedef struct {
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long sequence;
+    Donnee donnee;
+} Case;
+
+// --- LA FILE MPMC (Multi Producer / Multi Consumer, bornée) ---
+// 'pos_ecriture' et 'pos_lecture' sont des TICKETS : un producteur (resp. consommateur)
+// réserve sa case en avançant le ticket avec un CAS (Compare-And-Swap).
+// Deux producteurs n'obtiennent jamais le même ticket, et donc jamais la même case.
+typedef struct {
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long pos_ecriture; // Prochain ticket producteur
+    _Alignas(TAILLE_LIGNE) _Atomic unsigned long pos_lecture;  // Prochain ticket consommateur
+    _Alignas(TAILLE_LIGNE) Parking parking_prod;               // Les producteurs dorment ici si c'est plein
+    _Alignas(TAILLE_LIGNE) Parking parking_conso;              // Les consommateurs dorment ici si c'est vide
+    Case tab[N];
+} FileMPMC;
+
+FileMPMC file; // Variable globale : visible par tous les threads
+
+// --- GESTION DE L'ARRÊT ---
+volatile sig_atomic_t stop = 0;
+
+
+// ============================================================================
+// OPÉRATIONS NON BLOQUANTES SUR LA FILE
+// ============================================================================
+
+// Tente de déposer 'item'. Renvoie 1 si réussi, 0 si la file est pleine.
+// '*idx' reçoit l'index de la case utilisée (pour l'affichage).
+int file_deposer(const Donnee *item, unsigned long *idx) {
+    unsigned long pos = atomic_load_explicit(&file.pos_ecriture, memory_order_relaxed);
+    for (;;) {
+        Case *c = &file.tab[pos % N];
+        unsigned long seq = atomic_load_explicit(&c->sequence, memory_order_acquire);
+        long diff = (long) (seq - pos);
+
+        if (diff == 0) {
+            // La case est libre pour ce ticket : on essaie de le prendre.
+            // En cas d'échec, 'pos' est rechargé avec la valeur actuelle et on recommence.
+            if (atomic_compare_exchange_weak_explicit(&file.pos_ecriture, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                c->donnee = *item;
+                *idx = pos % N;
+                // release : la donnée est visible AVANT que la case ne soit marquée pleine.
+                atomic_store_explicit(&c->sequence, pos + 1, memory_order_release);
+                return 1;
+            }
+        } else if (diff < 0) {
+            return 0; // La case n'a pas encore été lue au tour précédent : file PLEINE
+        } else {
+            // Un autre producteur nous a devancés : on prend le ticket suivant.
+            pos = atomic_load_explicit(&file.pos_ecriture, memory_order_relaxed);
+        }
+    }
+}
+
+// Tente de retirer un item. Renvoie 1 si réussi, 0 si la file est vide.
+int file_retirer(Donnee *item, unsigned long *idx) {
+    unsigned long pos = atomic_load_explicit(&file.pos_lecture, memory_order_relaxed);
+    for (;;) {
+        Case *c = &file.tab[pos % N];
+        unsigned long seq = atomic_load_explicit(&c->sequence, memory_order_acquire);
+        long diff = (long) (seq - (pos + 1));
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&file.pos_lecture, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                *item = c->donnee;
+                *idx = pos % N;
+                // La case est rendue aux producteurs pour le tour suivant.
+                atomic_store_explicit(&c->sequence, pos + N, memory_order_release);
+                return 1;
+            }
+        } else if (diff < 0) {
+            return 0; // Rien n'a encore été écrit pour ce ticket : file VIDE
+        } else {
+            pos = atomic_load_explicit(&file.pos_lecture, memory_order_relaxed);
+        }
+    }
+}
+
+
+// ============================================================================
+// GESTIONNAIRE DE SIGNAL (L'interception du Ctrl+C)
+// ============================================================================
+void handler(int sig) {
+    stop = 1;
+    // On réveille TOUS les dormeurs des deux côtés pour qu'ils voient 'stop'.
+    parking_secouer(&file.parking_prod, 1);
+    parking_secouer(&file.parking_conso, 1);
+}
+
+
+// ============================================================================
+// ROUTINE DES PRODUCTEURS
+// ============================================================================
+void * producteur(void * arg) {
+    int id = (int) (long) arg; // Numéro du producteur (passé par pthread_create)
+    int k = 0;
+
+    while (!stop) {
+        Donnee item;
+        unsigned long idx;
+        snprintf(item.texte, TAILLE_MSG, "P%d-Msg %d", id, k++);
+
+        // --- Dépôt : on ne dort QUE si la file est vraiment pleine ---
+        while (!stop && !file_deposer(&item, &idx)) {
+            unsigned int v = parking_preparer(&file.parking_prod);
+            // Re-vérification : la case de notre prochain ticket est-elle toujours occupée ?
+            unsigned long pos = atomic_load_explicit(&file.pos_ecriture, memory_order_seq_cst);
+            unsigned long seq = atomic_load_explicit(&file.tab[pos % N].sequence, memory_order_seq_cst);
+            if ((long) (seq - pos) < 0 && !stop) {
+                parking_dormir(&file.parking_prod, v, 1);
+            } else {
+                parking_annuler(&file.parking_prod);
+            }
+        }
+        if (stop) break;
+
+        printf("-> Producteur %d : Ecrit '%s' index %lu\n", id, item.texte, idx);
+        parking_reveiller(&file.parking_conso, 1);
+
+        sleep(1);
+    }
+
+    printf("--- Arrêt (SIGINT) : Fin du Producteur %d ---\n", id);
+    pthread_exit(NULL);
+}
+
+// ============================================================================
+// ROUTINE DES CONSOMMATEURS
+// ============================================================================
+void * consommateur(void * arg) {
+    int id = (int) (long) arg;
+
+    while (!stop) {
+        Donnee item;
+        unsigned long idx;
+
+        // --- Retrait : on ne dort QUE si la file est vraiment vide ---
+        while (!stop && !file_retirer(&item, &idx)) {
+            unsigned int v = parking_preparer(&file.parking_conso);
+            unsigned long pos = atomic_load_explicit(&file.pos_lecture, memory_order_seq_cst);
+            unsigned long seq = atomic_load_explicit(&file.tab[pos % N].sequence, memory_order_seq_cst);
+            if ((long) (seq - (pos + 1)) < 0 && !stop) {
+                parking_dormir(&file.parking_conso, v, 1);
+            } else {
+                parking_annuler(&file.parking_conso);
+            }
+        }
+        if (stop) break;
+
+        printf("<- Consommateur %d : Lu '%s' index %lu\n", id, item.texte, idx);
+        parking_reveiller(&file.parking_prod, 1);
+
+        sleep(1);
+    }
+
+    printf("--- Arrêt (SIGINT) : Fin du Consommateur %d ---\n", id);
+    pthread_exit(NULL);
+}
+
+// ============================================================================
+// FONCTION PRINCIPALE
+// ============================================================================
+// Usage : ./5-Thread [nb_producteurs] [nb_consommateurs]   (1 et 1 par défaut)
+int main(int argc, char *argv[]) {
+    int nb_prod = (argc > 1) ? atoi(argv[1]) : 1;
+    int nb_conso = (argc > 2) ? atoi(argv[2]) : 1;
+
+    if (nb_prod < 1 || nb_prod > MAX_THREADS || nb_conso < 1 || nb_conso > MAX_THREADS) {
+        fprintf(stderr, "Usage : %s [nb_producteurs] [nb_consommateurs] (1 à %d)\n", argv[0], MAX_THREADS);
+        exit(1);
+    }
+
+    // --- 1. Configuration du Signal ---
+    struct sigaction sa;
+    sa.sa_handler = handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGINT, &sa, NULL);
+
+    pthread_t th_prod[MAX_THREADS], th_conso[MAX_THREADS];
+
+    printf("--- Debut avec Threads V5 (File MPMC : %d producteur(s), %d consommateur(s)) ---\n",
+           nb_prod, nb_conso);
+
+    // --- 2. Initialisation de la file ---
+    // Au départ, la case k attend le producteur qui aura le ticket k.
+    for (int k = 0; k < N; k++) {
+        atomic_init(&file.tab[k].sequence, k);
+    }
+
+    // --- 3. Lancement des Threads ---
+    // Le numéro du thread est passé directement dans le pointeur 'arg'.
+    for (int t = 0; t < nb_prod; t++) {
+        if (pthread_create(&th_prod[t], NULL, producteur, (void *) (long) t) != 0) {
+            perror("Erreur création producteur");
+            exit(1);
+        }
+    }
+    for (int t = 0; t < nb_conso; t++) {
+        if (pthread_create(&th_conso[t], NULL, consommateur, (void *) (long) t) != 0) {
+            perror("Erreur création consommateur");
+            exit(1);
+        }
+    }
+
+    // --- 4. Attente ---
+    for (int t = 0; t < nb_prod; t++) pthread_join(th_prod[t], NULL);
+    for (int t = 0; t < nb_conso; t++) pthread_join(th_conso[t], NULL);
+
+    printf("--- Fin du processus principal ---\n");
+    return 0;
+}